@@ -0,0 +1,158 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+//
+// Comparison of the EM physics constructors (PhysicsList::AddPhysicsList)
+// at MARLEY energies: electrons and gammas of 5, 10, 20 and 50 MeV are
+// simulated with each option and the time per event and the photons on
+// windows per event are printed, the latter as a ratio to the first
+// option. The physics of a run manager cannot be changed once initialised,
+// so every option and primary runs in a forked process that sends its
+// result back through a pipe; the initialisation time is reported as well.
+//
+//   bench_emphysics [nEvents] [seed] [option ...]
+//
+// Default options: emstandard_opt4 (reference) local standard livermore
+// penelope emstandard_opt0. The primaries start at (0, 0, 2) m as in
+// MARLEYg4.C; each child overwrites arapuca.root.
+
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "ActionInitialization.hh"
+#include "Run.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+struct Result {
+  G4double msInit;
+  G4double msPerEvent;
+  G4double weight, weight2;   // photons on windows (weighted) and sum of w^2
+  G4bool   ok;
+};
+
+static const G4int kParticles[2] = {11, 22};
+static const char* kParticleNames[2] = {"e-", "gamma"};
+static const G4double kEnergies[4] = {5., 10., 20., 50.};
+
+static Result Simulate(const G4String& option, G4int pdg, G4double ke, G4int nEvents, G4long seed)
+{
+  Result r;
+  r.ok = false;
+  G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  CLHEP::HepRandom::setTheSeed(seed);
+
+  std::chrono::high_resolution_clock::time_point start =
+    std::chrono::high_resolution_clock::now();
+  G4RunManager* runManager = new G4RunManager;
+  DetectorConstruction* detector = new DetectorConstruction;
+  detector->SetChannelMapFile("");
+  runManager->SetUserInitialization(detector);
+  PhysicsList* physics = new PhysicsList();
+  physics->AddPhysicsList(option);
+  runManager->SetUserInitialization(physics);
+  if(physics->GetEmName() != option){
+    delete runManager;
+    return r;
+  }
+  runManager->SetUserInitialization(new ActionInitialization(detector,physics,0.,0.,2.,pdg,ke));
+  runManager->Initialize();
+  runManager->BeamOn(0);  // tables
+  std::chrono::duration<G4double, std::milli> init =
+    std::chrono::high_resolution_clock::now() - start;
+  r.msInit = init.count();
+
+  start = std::chrono::high_resolution_clock::now();
+  runManager->BeamOn(nEvents);
+  std::chrono::duration<G4double, std::milli> elapsed =
+    std::chrono::high_resolution_clock::now() - start;
+  r.msPerEvent = elapsed.count()/nEvents;
+
+  const B1Run* run = static_cast<const B1Run*>(runManager->GetCurrentRun());
+  r.weight = run->GetDetWeight();
+  r.weight2 = run->GetDetWeight2();
+  r.ok = true;
+
+  delete runManager;
+  return r;
+}
+
+static Result Fork(const G4String& option, G4int pdg, G4double ke, G4int nEvents, G4long seed)
+{
+  Result r;
+  r.ok = false;
+  int fd[2];
+  if(pipe(fd) != 0) return r;
+  pid_t pid = fork();
+  if(pid == 0){
+    close(fd[0]);
+    Result child = Simulate(option, pdg, ke, nEvents, seed);
+    ssize_t written = write(fd[1], &child, sizeof(child));
+    _exit(written == ssize_t(sizeof(child)) ? 0 : 1);
+  }
+  close(fd[1]);
+  if(pid > 0){
+    if(read(fd[0], &r, sizeof(r)) != ssize_t(sizeof(r))) r.ok = false;
+    waitpid(pid, 0, 0);
+  }
+  close(fd[0]);
+  return r;
+}
+
+int main(int argc, char** argv)
+{
+  G4int nEvents = (argc > 1) ? std::atoi(argv[1]) : 5;
+  G4long seed = (argc > 2) ? std::atol(argv[2]) : 12345;
+  std::vector<G4String> options;
+  for(G4int i=3; i<argc; i++) options.push_back(argv[i]);
+  if(options.empty()){
+    const char* defaults[6] = {"emstandard_opt4", "local", "standard", "livermore",
+                               "penelope", "emstandard_opt0"};
+    options.assign(defaults, defaults+6);
+  }
+
+  // results[option][particle*4 + energy]
+  std::vector<std::vector<Result> > results(options.size());
+  for(size_t k=0; k<options.size(); k++)
+    for(G4int p=0; p<2; p++)
+      for(G4int e=0; e<4; e++)
+        results[k].push_back(Fork(options[k], kParticles[p], kEnergies[e], nEvents, seed));
+
+  G4cout << nEvents << " events per option and primary, seed " << seed
+         << "; photons per event and ratio to " << options[0] << G4endl;
+  for(size_t k=0; k<options.size(); k++){
+    const std::vector<Result>& res = results[k];
+    if(!res[0].ok){
+      G4cout << options[k] << ": failed (unknown option?)" << G4endl;
+      continue;
+    }
+    G4cout << options[k] << ": initialisation " << res[0].msInit << " ms" << G4endl;
+    for(G4int p=0; p<2; p++){
+      for(G4int e=0; e<4; e++){
+        const Result& r = res[4*p+e];
+        const Result& ref = results[0][4*p+e];
+        if(!r.ok) continue;
+        // ratio error taking the runs as independent
+        G4double ratio = (ref.ok && ref.weight > 0.) ? r.weight/ref.weight : 0.;
+        G4double error = (r.weight > 0. && ref.ok && ref.weight > 0.) ?
+          ratio*std::sqrt(r.weight2/(r.weight*r.weight) + ref.weight2/(ref.weight*ref.weight)) : 0.;
+        G4cout << "  " << kParticleNames[p] << " " << kEnergies[e] << " MeV: "
+               << r.msPerEvent << " ms/event, photons " << r.weight/nEvents << " +- "
+               << std::sqrt(r.weight2)/nEvents << " (ratio " << ratio << " +- " << error << ")"
+               << G4endl;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,163 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+//
+// Validation of the simplified field-cage solids: the same events are
+// simulated with the exact profiles, the extruded polygons and the box
+// slabs (DetectorConstruction::SetFieldCageShape), and the photons on
+// windows and the time per event are compared. For each shape straight
+// rays are then traced from random points of the LAr with G4Navigator
+// (as in bench_navigation) to give the time per step and the fraction of
+// rays stopped by a field-cage profile.
+//
+//   bench_fieldcage [nEvents] [nSteps] [seed] [pdg] [KE/MeV] [x/m] [y/m] [z/m]
+//
+// The default primary is a 1 MeV electron 0.75 m from the +x field cage.
+
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "ActionInitialization.hh"
+#include "Run.hh"
+
+#include "G4RunManager.hh"
+#include "G4Navigator.hh"
+#include "G4GeometryManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+struct Result {
+  G4double weight, weight2;   // photons on windows (weighted) and sum of w^2
+  G4double msPerEvent;
+  G4double nsPerStep;
+  G4double fcFraction;        // rays ending on a field-cage profile
+};
+
+static G4ThreeVector Isotropic()
+{
+  G4double cost = 2.*G4UniformRand() - 1.;
+  G4double sint = std::sqrt(1. - cost*cost);
+  G4double phi = CLHEP::twopi*G4UniformRand();
+  return G4ThreeVector(sint*std::cos(phi), sint*std::sin(phi), cost);
+}
+
+static void Trace(DetectorConstruction* detector, G4int n, G4long seed, Result& r)
+{
+  G4VPhysicalVolume* world =
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  G4GeometryManager::GetInstance()->CloseGeometry(true);
+  G4Material* lAr = G4Material::GetMaterial("G4_lAr");
+  G4ThreeVector half = detector->GetActiveHalfSize();
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+  CLHEP::HepRandom::setTheSeed(seed);
+
+  G4int steps = 0, rays = 0, fcRays = 0;
+  G4double ns = 0.;
+  while(steps < n){
+    G4ThreeVector pos(half.x()*(2.*G4UniformRand()-1.), half.y()*(2.*G4UniformRand()-1.),
+                      half.z()*(2.*G4UniformRand()-1.));
+    G4ThreeVector dir = Isotropic();
+    G4VPhysicalVolume* pv = navigator.LocateGlobalPointAndSetup(pos, &dir, false, false);
+    if(!pv || pv->GetLogicalVolume()->GetMaterial() != lAr) continue;
+    rays++;
+
+    std::chrono::high_resolution_clock::time_point start =
+      std::chrono::high_resolution_clock::now();
+    while(steps < n){
+      G4double safety;
+      G4double step = navigator.ComputeStep(pos, dir, kInfinity, safety);
+      steps++;
+      if(step == kInfinity) break;
+      pos += step*dir;
+      navigator.SetGeometricallyLimitedStep();
+      pv = navigator.LocateGlobalPointAndSetup(pos, &dir, true);
+      if(!pv || pv->GetLogicalVolume()->GetMaterial() != lAr) break;
+    }
+    std::chrono::duration<G4double, std::nano> elapsed =
+      std::chrono::high_resolution_clock::now() - start;
+    ns += elapsed.count();
+    if(pv && pv->GetLogicalVolume()->GetName().find("FieldCage") == 0) fcRays++;
+  }
+  r.nsPerStep = ns/steps;
+  r.fcFraction = G4double(fcRays)/rays;
+}
+
+static Result Run(G4RunManager* runManager, DetectorConstruction* detector, G4int shape,
+                  G4int nEvents, G4int nSteps, G4long seed)
+{
+  Result r;
+  detector->SetFieldCageShape(shape);
+  runManager->BeamOn(0);  // geometry and tables, not timed
+
+  CLHEP::HepRandom::setTheSeed(seed);
+  std::chrono::high_resolution_clock::time_point start =
+    std::chrono::high_resolution_clock::now();
+  runManager->BeamOn(nEvents);
+  std::chrono::duration<G4double, std::milli> elapsed =
+    std::chrono::high_resolution_clock::now() - start;
+  r.msPerEvent = elapsed.count()/nEvents;
+
+  const B1Run* run = static_cast<const B1Run*>(runManager->GetCurrentRun());
+  r.weight = run->GetDetWeight();
+  r.weight2 = run->GetDetWeight2();
+
+  Trace(detector, nSteps, seed, r);
+  return r;
+}
+
+static void Print(const char* name, const Result& r, const Result& exact)
+{
+  // ratio error taking the runs as independent; they share the seed, so
+  // this overestimates it
+  G4double ratio = (exact.weight > 0.) ? r.weight/exact.weight : 0.;
+  G4double error = (r.weight > 0. && exact.weight > 0.) ?
+    ratio*std::sqrt(r.weight2/(r.weight*r.weight) + exact.weight2/(exact.weight*exact.weight)) : 0.;
+  G4cout << name << ": photons " << r.weight << " +- " << std::sqrt(r.weight2)
+         << " (ratio " << ratio << " +- " << error << "), " << r.msPerEvent << " ms/event, "
+         << r.nsPerStep << " ns/step, " << 100.*r.fcFraction << "% of rays on field cage" << G4endl;
+}
+
+int main(int argc, char** argv)
+{
+  G4int nEvents = (argc > 1) ? std::atoi(argv[1]) : 10;
+  G4int nSteps = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+  G4long seed = (argc > 3) ? std::atol(argv[3]) : 12345;
+  G4int pdg = (argc > 4) ? std::atoi(argv[4]) : 11;
+  G4double ke = (argc > 5) ? std::atof(argv[5]) : 1.;
+  G4double x = (argc > 6) ? std::atof(argv[6]) : 6.;
+  G4double y = (argc > 7) ? std::atof(argv[7]) : 0.;
+  G4double z = (argc > 8) ? std::atof(argv[8]) : 0.;
+
+  G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  G4RunManager* runManager = new G4RunManager;
+  DetectorConstruction* detector = new DetectorConstruction;
+  runManager->SetUserInitialization(detector);
+  PhysicsList* physics = new PhysicsList();
+  runManager->SetUserInitialization(physics);
+  runManager->SetUserInitialization(new ActionInitialization(detector,physics,x,y,z,pdg,ke));
+  runManager->Initialize();
+
+  Result exact = Run(runManager, detector, DetectorConstruction::kFieldCageExact, nEvents, nSteps, seed);
+  Result polygon = Run(runManager, detector, DetectorConstruction::kFieldCagePolygon, nEvents, nSteps, seed);
+  Result slab = Run(runManager, detector, DetectorConstruction::kFieldCageSlab, nEvents, nSteps, seed);
+
+  G4cout << nEvents << " events (pdg " << pdg << ", " << ke << " MeV at " << x << ", " << y << ", "
+         << z << " m), " << nSteps << " ray steps, seed " << seed << G4endl;
+  Print("exact  ", exact, exact);
+  Print("polygon", polygon, exact);
+  Print("slab   ", slab, exact);
+
+  delete runManager;
+  return 0;
+}
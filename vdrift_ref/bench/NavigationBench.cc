@@ -0,0 +1,223 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+//
+// Navigation benchmark: the detector is built without physics for each
+// layout given on the command line and navigated with G4Navigator alone.
+//
+//  - locate: LocateGlobalPointAndSetup from scratch at random points of
+//    the box bounded by the cryostat walls and the anode/cathode planes,
+//    timed per call and attributed to the volume found;
+//  - step: straight rays started at random points of the LAr with
+//    isotropic directions, followed with ComputeStep and a relocation
+//    until they reach a volume that is not LAr; each step is timed and
+//    attributed to the volume it starts in.
+//
+// The cost of reading the clock is measured first and subtracted. For each
+// layout the totals (ns per locate, per step and per ray) are printed,
+// then the volumes taking most of the time. Containers add LAr-LAr steps,
+// so compare layouts per ray.
+//
+//   bench_navigation [nSteps] [seed] [layout ...]
+//
+// A layout is a '+'-separated list of flat, containers, parameterised,
+// exact, polygon and slab (e.g. containers+slab); default "flat containers".
+
+#include "DetectorConstruction.hh"
+
+#include "G4Navigator.hh"
+#include "G4GeometryManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+struct Timing {
+  G4double ns;
+  G4long   n;
+  Timing() : ns(0.), n(0) {}
+  void Add(G4double t) { ns += t; n++; }
+};
+
+struct Result {
+  Timing locate, step;
+  G4int rays;
+  G4double length;
+  std::map<G4String, Timing> locateByVolume, stepByVolume;
+};
+
+static G4double ClockOverhead()
+{
+  const G4int n = 100000;
+  G4double ns = 0.;
+  for(G4int i=0; i<n; i++){
+    Clock::time_point start = Clock::now();
+    std::chrono::duration<G4double, std::nano> elapsed = Clock::now() - start;
+    ns += elapsed.count();
+  }
+  return ns/n;
+}
+
+static G4ThreeVector Isotropic()
+{
+  G4double cost = 2.*G4UniformRand() - 1.;
+  G4double sint = std::sqrt(1. - cost*cost);
+  G4double phi = CLHEP::twopi*G4UniformRand();
+  return G4ThreeVector(sint*std::cos(phi), sint*std::sin(phi), cost);
+}
+
+static G4bool Configure(DetectorConstruction* detector, const G4String& layout)
+{
+  detector->SetContainers(false);
+  detector->SetParameterised(false);
+  detector->SetFieldCageShape(DetectorConstruction::kFieldCageExact);
+  std::istringstream in(layout);
+  std::string item;
+  while(std::getline(in, item, '+')){
+    if(item == "flat") detector->SetContainers(false);
+    else if(item == "containers") detector->SetContainers(true);
+    else if(item == "parameterised") detector->SetParameterised(true);
+    else if(item == "exact") detector->SetFieldCageShape(DetectorConstruction::kFieldCageExact);
+    else if(item == "polygon") detector->SetFieldCageShape(DetectorConstruction::kFieldCagePolygon);
+    else if(item == "slab") detector->SetFieldCageShape(DetectorConstruction::kFieldCageSlab);
+    else {
+      G4cerr << "bench_navigation: unknown layout option " << item << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+static const G4String& VolumeName(const G4VPhysicalVolume* pv)
+{
+  static const G4String outside("(outside)");
+  return pv ? pv->GetLogicalVolume()->GetName() : outside;
+}
+
+static Result Run(DetectorConstruction* detector, G4int n, G4long seed, G4double overhead)
+{
+  G4VPhysicalVolume* world = detector->Construct();
+  G4GeometryManager::GetInstance()->CloseGeometry(true);
+  G4Material* lAr = G4Material::GetMaterial("G4_lAr");
+  G4ThreeVector half = detector->GetActiveHalfSize();
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+  CLHEP::HepRandom::setTheSeed(seed);
+
+  Result r;
+  r.rays = 0;
+  r.length = 0.;
+
+  for(G4int i=0; i<n; i++){
+    G4ThreeVector pos(half.x()*(2.*G4UniformRand()-1.), half.y()*(2.*G4UniformRand()-1.),
+                      half.z()*(2.*G4UniformRand()-1.));
+    Clock::time_point start = Clock::now();
+    G4VPhysicalVolume* pv = navigator.LocateGlobalPointAndSetup(pos, 0, false, false);
+    std::chrono::duration<G4double, std::nano> elapsed = Clock::now() - start;
+    G4double ns = elapsed.count() - overhead;
+    r.locate.Add(ns);
+    r.locateByVolume[VolumeName(pv)].Add(ns);
+  }
+
+  G4long steps = 0;
+  while(steps < n){
+    // a start in the LAr, not timed
+    G4ThreeVector pos(half.x()*(2.*G4UniformRand()-1.), half.y()*(2.*G4UniformRand()-1.),
+                      half.z()*(2.*G4UniformRand()-1.));
+    G4ThreeVector dir = Isotropic();
+    G4VPhysicalVolume* pv = navigator.LocateGlobalPointAndSetup(pos, &dir, false, false);
+    if(!pv || pv->GetLogicalVolume()->GetMaterial() != lAr) continue;
+    r.rays++;
+
+    while(steps < n){
+      G4double safety;
+      const G4String& volume = VolumeName(pv);
+      Clock::time_point start = Clock::now();
+      G4double step = navigator.ComputeStep(pos, dir, kInfinity, safety);
+      if(step != kInfinity){
+        navigator.SetGeometricallyLimitedStep();
+        pv = navigator.LocateGlobalPointAndSetup(pos + step*dir, &dir, true);
+      }
+      std::chrono::duration<G4double, std::nano> elapsed = Clock::now() - start;
+      G4double ns = elapsed.count() - overhead;
+      r.step.Add(ns);
+      r.stepByVolume[volume].Add(ns);
+      steps++;
+      if(step == kInfinity) break;
+      r.length += step;
+      pos += step*dir;
+      if(!pv || pv->GetLogicalVolume()->GetMaterial() != lAr) break;
+    }
+  }
+  return r;
+}
+
+static void PrintVolumes(const char* what, const std::map<G4String, Timing>& byVolume, const Timing& total)
+{
+  std::vector<std::pair<G4double, G4String> > order;
+  for(std::map<G4String, Timing>::const_iterator it = byVolume.begin(); it != byVolume.end(); ++it)
+    order.push_back(std::make_pair(it->second.ns, it->first));
+  std::sort(order.rbegin(), order.rend());
+
+  G4cout << "  " << what << " by volume (ns/call, share of calls, share of time):" << G4endl;
+  for(size_t k=0; k<order.size() && k<10; k++){
+    const Timing& t = byVolume.find(order[k].second)->second;
+    G4cout << "    " << order[k].second << ": " << t.ns/t.n << ", "
+           << 100.*t.n/total.n << "%, " << 100.*t.ns/total.ns << "%" << G4endl;
+  }
+  if(order.size() > 10) G4cout << "    (" << order.size()-10 << " more)" << G4endl;
+}
+
+static void Print(const G4String& layout, const Result& r)
+{
+  G4cout << layout << ": " << r.locate.ns/r.locate.n << " ns/locate, "
+         << r.step.ns/r.step.n << " ns/step, " << r.step.ns/r.rays << " ns/ray, "
+         << G4double(r.step.n)/r.rays << " steps/ray, <step> = " << r.length/r.step.n/mm << " mm" << G4endl;
+  PrintVolumes("locate", r.locateByVolume, r.locate);
+  PrintVolumes("step", r.stepByVolume, r.step);
+}
+
+int main(int argc, char** argv)
+{
+  G4int n = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+  G4long seed = (argc > 2) ? std::atol(argv[2]) : 12345;
+  std::vector<G4String> layouts;
+  for(G4int i=3; i<argc; i++) layouts.push_back(argv[i]);
+  if(layouts.empty()){
+    layouts.push_back("flat");
+    layouts.push_back("containers");
+  }
+
+  DetectorConstruction* detector = new DetectorConstruction;
+  detector->SetChannelMapFile("");
+  G4double overhead = ClockOverhead();
+
+  std::vector<Result> results;
+  for(size_t k=0; k<layouts.size(); k++){
+    if(!Configure(detector, layouts[k])) return 1;
+    results.push_back(Run(detector, n, seed, overhead));
+  }
+
+  G4cout << n << " locates and steps per layout, seed " << seed
+         << ", clock overhead " << overhead << " ns (subtracted)" << G4endl;
+  for(size_t k=0; k<results.size(); k++) Print(layouts[k], results[k]);
+  for(size_t k=1; k<results.size(); k++)
+    G4cout << "speed-up per ray of " << layouts[k] << " over " << layouts[0] << ": "
+           << (results[0].step.ns/results[0].rays)/(results[k].step.ns/results[k].rays) << G4endl;
+
+  delete detector;
+  return 0;
+}
@@ -0,0 +1,143 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+//
+// Micro-benchmark of Rayleigh scattering: G4OpRayleigh, FastOpRayleigh and
+// the RayleighSampler batch kernel, each started from the same engine seed.
+// A photon random walk of n scatters is run per mode; the time per scatter
+// and the moments of the scattering angle (<cos> = 0, <cos^2> = 0.4 for
+// 1+cos^2) are printed.
+//
+//   bench_rayleigh [nScatters] [seed]
+
+#include "FastOpRayleigh.hh"
+#include "OpticalConstants.hh"
+#include "RayleighSampler.hh"
+
+#include "G4OpRayleigh.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleChange.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+struct Result {
+  G4double nsPerScatter;
+  G4double cos1, cos2;
+};
+
+static void Print(const char* name, const Result& r)
+{
+  G4cout << name << ": " << r.nsPerScatter << " ns/scatter, <cos> = "
+         << r.cos1 << ", <cos^2> = " << r.cos2 << G4endl;
+}
+
+// random walk through a process' PostStepDoIt
+static Result RunProcess(G4VProcess* process, G4int n, G4long seed)
+{
+  CLHEP::HepRandom::setTheSeed(seed);
+
+  G4DynamicParticle* particle =
+    new G4DynamicParticle(G4OpticalPhoton::Definition(), G4ThreeVector(0.,0.,1.), 9.76*eV);
+  particle->SetPolarization(1.,0.,0.);
+  G4Track track(particle, 0., G4ThreeVector());
+  G4Step step;
+  step.SetTrack(&track);
+  track.SetStep(&step);
+
+  Result r = {0., 0., 0.};
+  std::chrono::high_resolution_clock::time_point start =
+    std::chrono::high_resolution_clock::now();
+  for(G4int i=0; i<n; i++){
+    G4ParticleChange* change =
+      static_cast<G4ParticleChange*>(process->PostStepDoIt(track, step));
+    const G4ThreeVector& dir = *change->GetMomentumDirection();
+    G4double c = dir*particle->GetMomentumDirection();
+    r.cos1 += c;
+    r.cos2 += c*c;
+    particle->SetMomentumDirection(dir);
+    particle->SetPolarization(change->GetPolarization()->x(),
+                              change->GetPolarization()->y(),
+                              change->GetPolarization()->z());
+  }
+  std::chrono::duration<G4double, std::nano> elapsed =
+    std::chrono::high_resolution_clock::now() - start;
+
+  r.nsPerScatter = elapsed.count()/n;
+  r.cos1 /= n;
+  r.cos2 /= n;
+  return r;
+}
+
+// independent photons advanced together through the batch kernel
+static Result RunBatch(const RayleighSampler& sampler, G4int n, G4long seed)
+{
+  CLHEP::HepRandom::setTheSeed(seed);
+
+  const G4int batch = 4096;
+  std::vector<G4double> dx(batch,0.), dy(batch,0.), dz(batch,1.);
+  std::vector<G4double> px(batch,1.), py(batch,0.), pz(batch,0.);
+  std::vector<G4double> ox(batch), oy(batch), oz(batch);
+  std::vector<G4double> rand(3*batch);
+
+  Result r = {0., 0., 0.};
+  G4int done = 0;
+  G4double ns = 0.;
+  while(done < n){
+    G4int m = std::min(batch, n-done);
+    for(G4int i=0; i<m; i++){ ox[i] = dx[i]; oy[i] = dy[i]; oz[i] = dz[i]; }
+
+    std::chrono::high_resolution_clock::time_point start =
+      std::chrono::high_resolution_clock::now();
+    CLHEP::HepRandom::getTheEngine()->flatArray(3*m, &rand[0]);
+    sampler.ScatterBatch(m, &dx[0], &dy[0], &dz[0], &px[0], &py[0], &pz[0], &rand[0]);
+    std::chrono::duration<G4double, std::nano> elapsed =
+      std::chrono::high_resolution_clock::now() - start;
+    ns += elapsed.count();
+
+    for(G4int i=0; i<m; i++){
+      G4double c = ox[i]*dx[i] + oy[i]*dy[i] + oz[i]*dz[i];
+      r.cos1 += c;
+      r.cos2 += c*c;
+    }
+    done += m;
+  }
+
+  r.nsPerScatter = ns/n;
+  r.cos1 /= n;
+  r.cos2 /= n;
+  return r;
+}
+
+int main(int argc, char** argv)
+{
+  G4int n = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+  G4long seed = (argc > 2) ? std::atol(argv[2]) : 12345;
+
+  G4OpRayleigh stock;
+  OpticalConstants constants;
+  FastOpRayleigh fast(&constants);
+  RayleighSampler sampler;
+
+  Result rStock = RunProcess(&stock, n, seed);
+  Result rFast = RunProcess(&fast, n, seed);
+  Result rBatch = RunBatch(sampler, n, seed);
+
+  G4cout << n << " scatters, seed " << seed << G4endl;
+  Print("G4OpRayleigh  ", rStock);
+  Print("FastOpRayleigh", rFast);
+  Print("batch kernel  ", rBatch);
+  G4cout << "speed-up: process " << rStock.nsPerScatter/rFast.nsPerScatter
+         << ", batch " << rStock.nsPerScatter/rBatch.nsPerScatter << G4endl;
+
+  return 0;
+}
@@ -22,10 +22,43 @@
 #include "ActionInitialization.hh"
 #include "DetectorConstruction.hh"
 #include "PhysicsList.hh"
+#include "GeometryValidator.hh"
 #include <stdlib.h>
 
 int main(int argc,char** argv) {
 
+  // g4workshop --validate-geometry[=file]: overlap check of the geometry
+  // (not done at normal startup), results written to file
+  for(int i=1; i<argc; i++){
+    G4String arg = argv[i];
+    if(arg.find("--validate-geometry") != 0) continue;
+    G4String fileName = "geometry_validation.csv";
+    if(arg.find('=') != std::string::npos) fileName = arg.substr(arg.find('=')+1);
+    DetectorConstruction* detector = new DetectorConstruction;
+    GeometryValidator validator;
+    G4int nIssues = validator.Validate(detector->Construct());
+    validator.Write(fileName);
+    G4cout << "Geometry validation written to " << fileName << G4endl;
+    delete detector;
+    return nIssues > 0 ? 1 : 0;
+  }
+
+  // --gdml-cache=dir: read/write the geometry as GDML in dir (see
+  // DetectorConstruction::SetGdmlCache); --table-cache=dir: store/retrieve
+  // the physics tables in dir (PhysicsTableCache); --em=name: EM physics
+  // constructor (PhysicsList::AddPhysicsList); options do not count as
+  // arguments
+  G4String gdmlCache, tableCache, emPhysics;
+  int nargs = 1;
+  for(int i=1; i<argc; i++){
+    G4String arg = argv[i];
+    if(arg.find("--gdml-cache=") == 0) gdmlCache = arg.substr(13);
+    else if(arg.find("--table-cache=") == 0) tableCache = arg.substr(14);
+    else if(arg.find("--em=") == 0) emPhysics = arg.substr(5);
+    else argv[nargs++] = argv[i];
+  }
+  argc = nargs;
+
   // Choose the Random engine
   //  
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
@@ -45,9 +78,12 @@ int main(int argc,char** argv) {
   // Set mandatory user initialization classes
   
   DetectorConstruction* detector = new DetectorConstruction;
+  if(!gdmlCache.empty()) detector->SetGdmlCache(gdmlCache);
   runManager->SetUserInitialization(detector);
   
   PhysicsList* physics = new PhysicsList();
+  if(!tableCache.empty()) physics->SetPhysicsTableCache(tableCache);
+  if(!emPhysics.empty()) physics->AddPhysicsList(emPhysics);
 
   runManager->SetUserInitialization(physics);    
   // User action initialization
@@ -57,7 +93,7 @@ int main(int argc,char** argv) {
   double z = atof(argv[3]);
   int pdgcode=atoi(argv[4]);
   double KE=atof(argv[5]);
-  runManager->SetUserInitialization(new ActionInitialization(detector,x,y,z,pdgcode,KE));
+  runManager->SetUserInitialization(new ActionInitialization(detector,physics,x,y,z,pdgcode,KE));
   
   // Initialize G4 kernel
   
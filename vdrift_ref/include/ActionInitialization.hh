@@ -10,11 +10,12 @@
 #include "G4VUserActionInitialization.hh"
 
 class DetectorConstruction;
+class PhysicsList;
 
 class ActionInitialization : public G4VUserActionInitialization
 {
   public:
-  ActionInitialization(DetectorConstruction*, double x, double y, double z, int pdgcode, double KE);
+  ActionInitialization(DetectorConstruction*, PhysicsList*, double x, double y, double z, int pdgcode, double KE);
     virtual ~ActionInitialization();
 
     virtual void BuildForMaster() const;
@@ -22,6 +23,7 @@ class ActionInitialization : public G4VUserActionInitialization
 
   private:
   DetectorConstruction* fDetectorConstruction;
+  PhysicsList* fPhysicsList;
   double x0,y0,z0, KE0;
   int pdgcode0;
 };
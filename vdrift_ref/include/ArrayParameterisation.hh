@@ -0,0 +1,56 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef ArrayParameterisation_h
+#define ArrayParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+#include "G4RotationMatrix.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VTouchable;
+
+// Copies of one logical volume at arbitrary positions (used for the
+// Arapuca modules and field-cage profiles). Each copy carries the channel
+// code of its window, read back through the copy number when a photon
+// enters the scoring volume of the copy.
+
+class ArrayParameterisation : public G4VPVParameterisation
+{
+public:
+  ArrayParameterisation();
+  virtual ~ArrayParameterisation();
+
+  void AddCopy(const G4ThreeVector& pos, G4RotationMatrix* rot, G4int channel = -1);
+  void Shift(const G4ThreeVector& offset);
+
+  G4int GetNoCopies() const {return fPosition.size();}
+  const G4ThreeVector& GetPosition(G4int copyNo) const {return fPosition[copyNo];}
+  G4RotationMatrix* GetRotation(G4int copyNo) const {return fRotation[copyNo];}
+  G4int GetChannel(G4int copyNo) const {return fChannel[copyNo];}
+
+  // daughter of the copies that scores (the window), 0 if none
+  void SetScoringVolume(G4LogicalVolume* lv) {fScoring = lv;}
+  G4LogicalVolume* GetScoringVolume() const {return fScoring;}
+
+  virtual void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume*) const;
+
+  // channel of the window the touchable is in, -1 if it is not one
+  static G4int Channel(const G4VTouchable*);
+
+private:
+  std::vector<G4ThreeVector>     fPosition;
+  std::vector<G4RotationMatrix*> fRotation;
+  std::vector<G4int>             fChannel;
+  G4LogicalVolume*               fScoring;
+};
+
+#endif
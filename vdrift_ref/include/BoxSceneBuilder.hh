@@ -0,0 +1,53 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef BoxSceneBuilder_h
+#define BoxSceneBuilder_h 1
+
+#include "globals.hh"
+#include "G4AffineTransform.hh"
+#include "BoxTracer.hh"
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VSolid;
+class SteppingAction;
+class G4Material;
+
+// Exports the constructed geometry to a BoxScene: the LAr box is the
+// "Cryostat" volume, every non-LAr daughter becomes one or more boxes.
+// Boxes and box-minus-box solids (Arapuca frames) are exact; any other
+// solid (the elliptical field-cage profiles) is replaced by its bounding
+// box. LAr daughters (array containers, Arapuca modules) are descended
+// into, parameterised ones copy by copy. Reflectivities come from the
+// skins the boundary process would use, window codes from
+// SteppingAction::VolumeCode or, inside an ArrayParameterisation, from
+// the copy number.
+
+class BoxSceneBuilder
+{
+public:
+  BoxSceneBuilder(SteppingAction*);
+  ~BoxSceneBuilder();
+
+  G4bool Build(const G4VPhysicalVolume* world, G4double energy, BoxScene&);
+
+  G4int GetNApproximated() const {return fNApproximated;}
+
+private:
+  void AppendBoxes(G4VSolid*, const G4AffineTransform&, std::vector<TracerBox>&);
+  void AppendDaughters(const G4LogicalVolume* mother, const G4AffineTransform& motherT,
+                       G4double motherReflectivity, const G4LogicalVolume* scoring,
+                       G4int channel, BoxScene&);
+  G4double SkinReflectivity(const G4LogicalVolume*, G4double energy, G4bool& found) const;
+
+  SteppingAction* fStepping;
+  G4int           fNApproximated;
+  G4double        fEnergy;
+  const G4Material* fLAr;
+};
+
+#endif
@@ -0,0 +1,109 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef BoxTracer_h
+#define BoxTracer_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "RayleighSampler.hh"
+
+#include <vector>
+#include <utility>
+
+// Optical transport outside the Geant4 stepping loop for a scene of
+// axis-aligned boxes inside one LAr box (see BoxSceneBuilder). Photons
+// are traced in packets of kBoxTracerWidth lanes through a BVH of the
+// boxes; the slab tests use AVX-512 or AVX2 when compiled for them.
+// Bulk absorption and Rayleigh scattering use constant lengths; box
+// faces and the LAr box walls absorb with probability 1-R and reflect
+// Lambertian otherwise, as the dielectric_metal skins of the full
+// simulation do. A box with a volume code >= 0 scores every arrival.
+
+#if defined(__AVX512F__)
+const G4int kBoxTracerWidth = 8;
+#else
+const G4int kBoxTracerWidth = 4;
+#endif
+
+struct TracerBox {
+  G4double lo[3], hi[3];
+  G4int    code;          // scorer code, -1 for a plain reflector
+  G4double reflectivity;
+};
+
+struct BoxScene {
+  G4double lo[3], hi[3];  // LAr volume
+  G4double wallReflectivity;
+  G4double absLength;
+  G4double rayleighLength;
+  G4bool   periodicZ;     // z walls wrap around (reduced geometry)
+  std::vector<TracerBox> boxes;
+};
+
+class BoxTracer
+{
+public:
+  BoxTracer();
+  ~BoxTracer();
+
+  void SetScene(const BoxScene&);
+  G4bool HasScene() const {return fHasScene;}
+  const BoxScene& GetScene() const {return fScene;}
+
+  G4bool Contains(const G4ThreeVector&) const;
+
+  void AddPhoton(const G4ThreeVector& pos, const G4ThreeVector& dir,
+                 const G4ThreeVector& pol, G4double weight);
+  G4int GetNPhotons() const {return fX.size();}
+
+  // trace all queued photons and empty the queue; every arrival on a
+  // scoring box is appended as (code, weight)
+  void Trace(std::vector<std::pair<G4int,G4double> >& hits);
+  void Clear();
+
+  G4long GetNSteps() const {return fNSteps;}
+
+private:
+  struct Node {
+    G4double lo[3], hi[3];
+    G4int    first, count;  // leaf: range in fOrder
+    G4int    right;         // inner: second child, first child follows
+  };
+
+  struct Packet {
+    G4int    n;
+    G4int    index[kBoxTracerWidth];
+    G4double o[3][kBoxTracerWidth];
+    G4double inv[3][kBoxTracerWidth];
+    G4double tBest[kBoxTracerWidth];
+    G4int    hit[kBoxTracerWidth];
+  };
+
+  G4int  BuildNode(G4int first, G4int count);
+  void   Traverse(Packet&) const;
+  G4int  NodeMask(const G4double* lo, const G4double* hi, const Packet&, G4double* tEntry,
+                  G4bool entry) const;
+  G4int  HitFace(const TracerBox&, G4int photon, G4double& sign) const;
+  G4bool Reflect(G4int photon, G4int axis, G4double sign, G4double reflectivity);
+  void   Remove(G4int photon);
+
+  BoxScene              fScene;
+  G4bool                fHasScene;
+  std::vector<Node>     fNodes;
+  std::vector<G4int>    fOrder;   // box indices in BVH leaf order
+
+  // queued photons, one array per component
+  std::vector<G4double> fX, fY, fZ, fDx, fDy, fDz, fPx, fPy, fPz, fW;
+  std::vector<char>     fAlive;
+
+  RayleighSampler fSampler;
+  G4double        fEpsilon;
+  G4int           fMaxSteps;
+  G4long          fNSteps;
+};
+
+#endif
@@ -25,15 +25,133 @@
 #include "G4ChordFinder.hh"
 #include "G4ClassicalRK4.hh"
 
+#include <vector>
+#include <map>
+
+class DetectorMessenger;
+class G4GenericMessenger;
+class ArrayParameterisation;
+class EMShowerModel;
+
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
 public:
 
+  // Axis-aligned rectangle covering a set of coplanar Arapuca windows
+  struct WindowPlane {
+    G4int         axis;   // normal direction: 0=x, 1=y, 2=z
+    G4double      pos;    // plane coordinate along the normal
+    G4ThreeVector lo, hi; // extent of the windows on the plane
+  };
+
+  // One Arapuca window of the channel map. The id is the channel code of
+  // SteppingAction::VolumeCode (the bin of hv); the normal points from the
+  // window into the LAr.
+  enum ChannelGroup { kLateral, kCathode, kShort };
+  struct Channel {
+    G4int         id;
+    G4String      name;
+    G4int         group;
+    G4ThreeVector center, normal, size;
+  };
+
   DetectorConstruction();
   DetectorConstruction(double size);
   ~DetectorConstruction();
 
   G4VPhysicalVolume* Construct();
+
+  // Parameterised EM showers in the ActiveLAr region (EMShowerModel, one
+  // per thread, off until /testem/shower/active)
+  virtual void ConstructSDandField();
+
+  // Planes of the photosensitive windows (lateral x=+-, cathode y, short z=+-)
+  G4double GetLatWindowX() const {return fLatWindow_x;}
+  G4double GetBotWindowY() const {return fBotWindow_y;}
+  G4double GetShortWindowZ() const {return fShortWindow_z;}
+  const std::vector<WindowPlane>& GetWindowPlanes() const {return fWindowPlanes;}
+
+  // Channel map of the built geometry, rebuilt with the Arapucas and
+  // written as CSV after each construction (no file if the name is empty)
+  const std::vector<Channel>& GetChannels() const {return fChannels;}
+  static const char* GroupName(G4int group);
+  G4bool WriteChannelMap(const G4String& fileName) const;
+  void SetChannelMapFile(const G4String& name) {fChannelMapFile = name;}
+
+  // Box bounded by the cryostat walls and the anode/cathode planes
+  G4ThreeVector GetActiveHalfSize() const;
+
+  // Reduced geometry: n of the 3 m periods of the Arapuca layout, with
+  // periodic z ends (SteppingAction moves photons across). The periods
+  // built are the central ones of the full detector and keep their window
+  // names, so channel codes are those of the full detector; a point at z
+  // here is at z+GetPeriodShiftZ() there. 0 builds the full detector.
+  void SetPeriods(G4int n);
+  G4int GetPeriods() const {return fPeriods;}
+  G4bool IsPeriodic() const {return fPeriods > 0;}
+  G4int GetNumberOfPeriods() const {return IsPeriodic() ? fPeriods : fFullPeriods;}
+  G4double GetPeriodicHalfZ() const;
+  G4double GetPeriodShiftZ() const;
+
+  // Arapuca modules (frame + window) and long field-cage profiles as
+  // G4PVParameterised arrays; channels then come from the copy number
+  // (ArrayParameterisation::Channel) instead of the volume name
+  void SetParameterised(G4bool val);
+  G4bool IsParameterised() const {return fParameterised;}
+
+  // Arapucas of each wall, cathode Arapucas and field-cage sides grouped
+  // in LAr container boxes (placement mode only, the parameterised arrays
+  // are grouped anyway)
+  void SetContainers(G4bool val);
+  G4bool HasContainers() const {return fContainers;}
+
+  // Cross-section of the field-cage profiles: the exact shape (elliptical
+  // tube minus a box), an extruded polygon on the same outline, or a
+  // thin box slab with the shadow and the reflective perimeter of the
+  // exact profile (see FieldCageSolid)
+  enum FieldCageShape { kFieldCageExact, kFieldCagePolygon, kFieldCageSlab };
+  void SetFieldCageShape(G4int shape);
+  G4int GetFieldCageShape() const {return fFieldCageShape;}
+
+  // Smart voxels of the cryostat: smartless (Geant4 default 2) and
+  // voxelisation on/off, applied at the next run. With navigation
+  // statistics on, SteppingAction records the daughters tested per step
+  // (see NavigationStats) and the voxels are printed at each run start.
+  void SetSmartless(G4double val);
+  void SetVoxelise(G4bool val);
+  void SetNavigationStats(G4bool val) {fNavigationStats = val;}
+  G4bool GetNavigationStats() const {return fNavigationStats;}
+  void PrintVoxelStats() const;
+
+  // GDML of the built world with the window planes and surface tables as
+  // auxiliary information. With a cache directory set, the first
+  // construction reads <dir>/fd2_<key>.gdml when it exists (the key is a
+  // hash of the geometry parameters) and writes it otherwise.
+  G4bool WriteGdml(const G4String& fileName);
+  void SetGdmlCache(const G4String& dir) {fGdmlCacheDir = dir;}
+  G4String GetGeometryKey() const;
+  G4String GetGdmlCacheFile() const;
+
+  // Arapuca layout, set with the /testem/layout/ commands: rows, row
+  // pitch and columns per period on the lateral walls, groups per period
+  // and windows per group on the cathode, the x of the cathode windows
+  // (cycled through), the window size and the distance of the wall
+  // Arapucas from the cryostat wall; lengths in m. The values are used at
+  // the next construction, or at once by RebuildArapucas, which replaces
+  // only the Arapuca sub-assemblies in the built geometry.
+  void SetCathodeOffsets(G4String list);
+  void RebuildArapucas();
+
+  // Regions with their own production cuts: ActiveLAr (the cryostat),
+  // Arapuca (frames and windows) and Outer (the steel shell; PhysicsList
+  // gives the world outside it the same cuts). Electrons and positrons
+  // below the Outer minimum kinetic energy are killed in Outer and in the
+  // world (G4UserLimits, applied by G4UserSpecialCuts).
+  void SetRegionCut(const G4String& region, G4double cut);
+  void SetOuterMinEkin(G4double val);
+
+  // counts Construct() calls, to spot a rebuilt geometry
+  G4int GetNumberOfBuilds() const {return fNBuilds;}
     
 private:
 
@@ -64,6 +182,41 @@ private:
   G4double      fAPA_y;
   G4double      fAPA_z;
   G4double      fAPA_thickness;
+
+  G4double      fPeriod_z;
+  G4int         fFullPeriods;
+  G4int         fPeriods;
+  G4int         fPeriodOffset;  // full-detector index of the first period built
+  G4int         fNBuilds;
+  G4bool        fParameterised;
+  G4bool        fContainers;
+  G4int         fFieldCageShape;
+  G4double      fSmartless;
+  G4bool        fVoxelise;
+  G4bool        fNavigationStats;
+  G4bool        fMaterialsDefined;
+  G4String      fGdmlCacheDir;
+
+  G4int         fLatRows;
+  G4int         fLatColumns;      // per period
+  G4double      fLatRowPitch;
+  G4int         fCathodeGroups;   // per period, two rows of windows each
+  G4int         fCathodeWindows;  // per group
+  std::vector<G4double> fCathodeOffsets;
+  G4double      fDistFromCryoWall;
+  std::vector<G4VPhysicalVolume*> fArapucaPlacements;  // cryostat daughters
+  G4GenericMessenger* fLayoutMessenger;
+  std::map<G4String,G4double> fRegionCuts;
+  G4UserLimits* fOuterLimits;
+  static G4ThreadLocal EMShowerModel* fShowerModel;
+
+  G4double      fLatWindow_x;
+  G4double      fBotWindow_y;
+  G4double      fShortWindow_z;
+  std::vector<WindowPlane> fWindowPlanes;
+  std::vector<Channel> fChannels;
+  G4String      fChannelMapFile;
+  std::vector<ArrayParameterisation*> fArrays;  // owned, G4PVParameterised does not
  
 // Materials
 
@@ -79,12 +232,34 @@ private:
   G4VPhysicalVolume* fPhysiWorld;
   G4LogicalVolume*   fLogicWorld;  
   G4Box*             fSolidWorld;
+  G4LogicalVolume*   fLogicCryostat;
   
   G4VPhysicalVolume* fPhysiVol;
   G4LogicalVolume*   fLogicVol;  
   G4Box*             fSolidVol;
 
+  DetectorMessenger* fMessenger;
+
   void DefineMaterials();
+  void FindLoadedMaterials();
+  void SetLengths();
+  G4bool UseGdmlCache() const;
+  G4bool ReadGdml(const G4String& fileName);
+  G4LogicalVolume* GroupDaughters(G4LogicalVolume* mother, const G4String& name,
+                                  const std::vector<G4LogicalVolume*>& members,
+                                  G4int axis, G4int side);
+  void PlaceCopy(G4LogicalVolume*, G4RotationMatrix*, const G4ThreeVector&,
+                 G4int copyNo, ArrayParameterisation*, G4VPhysicalVolume* mother);
+  G4VPhysicalVolume* PlaceArray(const G4String& name, G4LogicalVolume*,
+                                ArrayParameterisation*, G4VPhysicalVolume* mother);
+  G4VSolid* FieldCageSolid(const G4String& name, G4double dy, G4double halfLength,
+                           G4double cutShift) const;
+  void DefineLayoutCommands();
+  void ConstructArapucas(G4VPhysicalVolume* cryostat, G4OpticalSurface* cryostatSurface);
+  void ConstructRegions();
+  void AddWindowToPlane(G4int axis, const G4ThreeVector& center, const G4ThreeVector& halfSize);
+  void AddChannel(const G4String& name, G4int group, const G4ThreeVector& center,
+                  const G4ThreeVector& normal, const G4ThreeVector& halfSize);
   G4VPhysicalVolume* ConstructLine();     
 
 };
@@ -0,0 +1,51 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef DetectorMessenger_h
+#define DetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+class DetectorMessenger: public G4UImessenger
+{
+  public:
+    DetectorMessenger(DetectorConstruction*);
+   ~DetectorMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    DetectorConstruction*  fDetector;
+
+    G4UIdirectory*         fDetDir;
+    G4UIcmdWithAnInteger*  fPeriodsCmd;
+    G4UIcmdWithABool*      fParamCmd;
+    G4UIcmdWithABool*      fContainersCmd;
+    G4UIcmdWithAString*    fFieldCageCmd;
+    G4UIcmdWithAString*    fGdmlCacheCmd;
+    G4UIcmdWithAString*    fWriteGdmlCmd;
+    G4UIcmdWithADouble*    fSmartlessCmd;
+    G4UIcmdWithABool*      fVoxeliseCmd;
+    G4UIcmdWithoutParameter* fVoxelStatsCmd;
+    G4UIcmdWithABool*      fNavStatsCmd;
+    G4UIcmdWithAString*    fChannelMapCmd;
+    G4UIcmdWithADoubleAndUnit* fActiveCutCmd;
+    G4UIcmdWithADoubleAndUnit* fArapucaCutCmd;
+    G4UIcmdWithADoubleAndUnit* fOuterCutCmd;
+    G4UIcmdWithADoubleAndUnit* fOuterMinEkinCmd;
+};
+
+#endif
@@ -0,0 +1,69 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef EMShowerModel_h
+#define EMShowerModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+#include <map>
+
+class G4Navigator;
+class EMShowerModelMessenger;
+
+// Parameterised electromagnetic showers in the scintillator of a region
+// (ActiveLAr, see DetectorConstruction::ConstructSDandField). Electrons,
+// positrons and gammas above fMinEnergy are killed and their energy is
+// deposited in spots of about fSpotEnergy:
+//  - longitudinal: gamma distribution in t = depth/X0 with b = 0.5 and
+//    a = 1 + b*max(ln(E/Ec) - 0.5, 0) (PDG); gammas first travel an
+//    exponential conversion length of 9/7 X0;
+//  - lateral: f(r) = 2rR^2/(r^2+R^2)^2 with R = R_M/3, 90% within R_M.
+// Spots in the material of the track give photons as G4Scintillation
+// would (yield, resolution scale, fast/slow spectra and time constants),
+// downscaled by the optical yield scale of the PhysicsList with weight 1/f.
+// The Cerenkov light of the shower is not produced.
+
+class EMShowerModel : public G4VFastSimulationModel
+{
+public:
+  EMShowerModel(const G4String& name, G4Region* region);
+  virtual ~EMShowerModel();
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition&);
+  virtual G4bool ModelTrigger(const G4FastTrack&);
+  virtual void   DoIt(const G4FastTrack&, G4FastStep&);
+
+  void SetActive(G4bool val)       {fActive = val;}
+  void SetMinEnergy(G4double val)  {fMinEnergy = val;}
+  void SetSpotEnergy(G4double val) {fSpotEnergy = val;}
+
+  G4bool IsActive() const {return fActive;}
+
+private:
+  struct Spot {
+    G4ThreeVector position;
+    G4double      time;
+    G4int         nPhotons;
+  };
+
+  G4double SampleEnergy(const G4MaterialPropertyVector*);
+
+  EMShowerModelMessenger* fMessenger;
+  G4Navigator*            fNavigator;
+
+  G4bool   fActive;
+  G4double fMinEnergy;
+  G4double fSpotEnergy;
+
+  std::vector<Spot> fSpots;
+  std::map<const G4MaterialPropertyVector*, std::vector<G4double> > fIntegrals;
+};
+
+#endif
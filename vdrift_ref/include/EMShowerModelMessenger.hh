@@ -0,0 +1,35 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef EMShowerModelMessenger_h
+#define EMShowerModelMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EMShowerModel;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+class EMShowerModelMessenger: public G4UImessenger
+{
+  public:
+    EMShowerModelMessenger(EMShowerModel*);
+   ~EMShowerModelMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    EMShowerModel*             fModel;
+
+    G4UIdirectory*             fShowerDir;
+    G4UIcmdWithABool*          fActiveCmd;
+    G4UIcmdWithADoubleAndUnit* fMinEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fSpotEnergyCmd;
+};
+
+#endif
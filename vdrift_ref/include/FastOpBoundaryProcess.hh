@@ -0,0 +1,59 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef FastOpBoundaryProcess_h
+#define FastOpBoundaryProcess_h 1
+
+#include "G4OpBoundaryProcess.hh"
+#include <map>
+
+class G4OpticalSurface;
+class G4Material;
+class OpticalConstants;
+
+// G4OpBoundaryProcess with a short path for the skins used here:
+// dielectric_metal, unified, ground, with no lobe/spike/backscatter
+// constants, no complex index and zero EFFICIENCY. For those the general
+// process reduces to absorb with probability 1-R or reflect Lambertian
+// about the surface normal, which is done directly. Any other boundary
+// goes through G4OpBoundaryProcess unchanged.
+
+class FastOpBoundaryProcess : public G4OpBoundaryProcess
+{
+public:
+  FastOpBoundaryProcess(const G4String& processName = "OpBoundary");
+  virtual ~FastOpBoundaryProcess();
+
+  virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  // status of the last step, whichever path handled it
+  G4OpBoundaryProcessStatus GetStatus() const;
+
+  void SetFastPath(G4bool val) {fFastPath = val;}
+  void SetOpticalConstants(OpticalConstants* val) {fConstants = val;}
+
+private:
+  struct SurfaceData {
+    G4bool fast;
+    G4MaterialPropertyVector* reflectivity;
+    G4double lineEnergy;        // reflectivity at the scintillation line
+    G4double lineReflectivity;
+  };
+
+  SurfaceData& GetSurfaceData(const G4OpticalSurface*);
+  G4bool HasRindex(const G4Material*);
+
+  OpticalConstants* fConstants;
+
+  G4bool fFastPath;
+  G4bool fLastFast;
+  G4OpBoundaryProcessStatus fFastStatus;
+
+  std::map<const G4OpticalSurface*, SurfaceData> fSurfaceData;
+  std::map<const G4Material*, G4bool>            fHasRindex;
+};
+
+#endif
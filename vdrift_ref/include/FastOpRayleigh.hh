@@ -0,0 +1,31 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef FastOpRayleigh_h
+#define FastOpRayleigh_h 1
+
+#include "OpRayleighMono.hh"
+#include "RayleighSampler.hh"
+
+// Rayleigh process whose scatter is drawn by RayleighSampler instead of
+// the accept/reject loop of G4OpRayleigh; mean free paths are unchanged
+
+class FastOpRayleigh : public OpRayleighMono
+{
+public:
+  FastOpRayleigh(OpticalConstants*, const G4String& processName = "OpRayleigh");
+  virtual ~FastOpRayleigh();
+
+  virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  void SetFastSampling(G4bool val) {fFastSampling = val;}
+
+private:
+  RayleighSampler fSampler;
+  G4bool          fFastSampling;
+};
+
+#endif
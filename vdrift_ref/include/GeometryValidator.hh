@@ -0,0 +1,83 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef GeometryValidator_h
+#define GeometryValidator_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4AffineTransform.hh"
+
+#include <vector>
+#include <map>
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VSolid;
+
+// Overlap check of a constructed geometry, run by
+// g4workshop --validate-geometry instead of pSurfChk at every startup.
+// Placements (and every copy of a parameterised volume) are checked as
+// G4PVPlacement::CheckOverlaps does: points sampled on the surface of a
+// daughter must lie inside its mother and outside its siblings. Surface
+// points are sampled once per solid; the point tests are spread over
+// threads, one placement at a time. Placements of the same logical
+// volume at the same position are reported as duplicates (they share
+// every surface, which the point test cannot see).
+
+class GeometryValidator
+{
+public:
+  struct Issue {
+    G4String      kind;       // "duplicate", "overlap" or "protrusion"
+    G4String      volume;
+    G4int         copy;
+    G4String      mother;
+    G4String      other;      // sibling, empty for a protrusion
+    G4int         otherCopy;
+    G4double      depth;      // largest penetration found
+    G4ThreeVector point;      // where, in the mother frame
+  };
+
+  GeometryValidator(G4int resolution = 1000, G4double tolerance = 0.,
+                    G4int nThreads = 0);
+  ~GeometryValidator();
+
+  // returns the number of issues found
+  G4int Validate(const G4VPhysicalVolume* world);
+
+  // one line per issue, comma separated, lengths in mm
+  G4bool Write(const G4String& fileName) const;
+
+  const std::vector<Issue>& GetIssues() const {return fIssues;}
+  G4int GetNumberOfPlacements() const {return fNPlacements;}
+
+private:
+  struct Placement {
+    const G4VSolid*  solid;
+    const G4String*  name;
+    G4int            copy;
+    G4AffineTransform toMother, fromMother;
+    G4ThreeVector    lo, hi;        // extent in the mother frame
+    G4int            duplicateOf;   // index in the mother's list, -1 if none
+  };
+
+  void CollectPlacements(const G4LogicalVolume* mother, std::vector<Placement>&);
+  void FindDuplicates(std::vector<Placement>&);
+  void CheckPlacement(const G4LogicalVolume* mother, const std::vector<Placement>&,
+                      size_t index, std::vector<Issue>&) const;
+  const std::vector<G4ThreeVector>& SurfacePoints(const G4VSolid*);
+
+  G4int    fResolution;
+  G4double fTolerance;
+  G4int    fNThreads;
+  G4int    fNPlacements;
+
+  std::map<const G4VSolid*, std::vector<G4ThreeVector> > fPoints;
+  std::vector<Issue> fIssues;
+};
+
+#endif
@@ -0,0 +1,28 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef NavigationStats_h
+#define NavigationStats_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4LogicalVolume;
+
+// Smart-voxel instrumentation. PrintVoxels summarises the voxel header
+// built for a volume when the geometry was closed; Candidates gives the
+// number of daughters the voxel navigation tests for a point of the
+// volume, i.e. the contents of the voxel node the point is in (all
+// daughters when the volume is not voxelised).
+
+class NavigationStats
+{
+public:
+  static void PrintVoxels(const G4LogicalVolume*);
+  static G4int Candidates(const G4LogicalVolume*, const G4ThreeVector& localPoint);
+};
+
+#endif
@@ -0,0 +1,29 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef OpAbsorptionMono_h
+#define OpAbsorptionMono_h 1
+
+#include "G4OpAbsorption.hh"
+
+class OpticalConstants;
+
+// G4OpAbsorption taking ABSLENGTH from OpticalConstants for photons at
+// the scintillation line; other photons use the property vector
+
+class OpAbsorptionMono : public G4OpAbsorption
+{
+public:
+  OpAbsorptionMono(OpticalConstants*, const G4String& processName = "OpAbsorption");
+  virtual ~OpAbsorptionMono();
+
+  virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+private:
+  OpticalConstants* fConstants;
+};
+
+#endif
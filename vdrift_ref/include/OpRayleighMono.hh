@@ -0,0 +1,30 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef OpRayleighMono_h
+#define OpRayleighMono_h 1
+
+#include "G4OpRayleigh.hh"
+
+class OpticalConstants;
+
+// G4OpRayleigh taking the RAYLEIGH length from OpticalConstants for
+// photons at the scintillation line; other photons use the physics table
+
+class OpRayleighMono : public G4OpRayleigh
+{
+public:
+  OpRayleighMono(OpticalConstants*, const G4String& processName = "OpRayleigh");
+  virtual ~OpRayleighMono();
+
+  virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+  virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+protected:
+  OpticalConstants* fConstants;
+};
+
+#endif
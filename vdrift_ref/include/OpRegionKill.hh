@@ -0,0 +1,44 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef OpRegionKill_h
+#define OpRegionKill_h 1
+
+#include "globals.hh"
+#include "G4VDiscreteProcess.hh"
+
+class G4LogicalVolume;
+
+// Optical physics confined to the cryostat. When active, optical photons
+// are killed at their first step in a volume outside it, i.e. in the
+// Outer region or the world (see DetectorConstruction::ConstructRegions),
+// and RegionRestricted generation processes make no photons there. The
+// switch is shared by all threads.
+
+class OpRegionKill : public G4VDiscreteProcess
+{
+public:
+  OpRegionKill(const G4String& processName = "OpRegionKill");
+  virtual ~OpRegionKill();
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition&);
+
+  virtual G4double PostStepGetPhysicalInteractionLength(const G4Track&, G4double,
+                                                        G4ForceCondition*);
+  virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*)
+    {return DBL_MAX;}
+
+  static void   SetActive(G4bool val) {fActive = val;}
+  static G4bool IsActive()            {return fActive;}
+  static G4bool IsOutside(const G4LogicalVolume*);
+
+private:
+  static G4bool fActive;
+};
+
+#endif
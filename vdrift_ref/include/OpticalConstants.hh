@@ -0,0 +1,54 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef OpticalConstants_h
+#define OpticalConstants_h 1
+
+#include "globals.hh"
+#include <vector>
+#include <cmath>
+
+class G4Material;
+
+// Optical properties of every material evaluated once at the scintillation
+// line. The line is taken from FASTCOMPONENT/SLOWCOMPONENT when all
+// scintillators share a single energy (9.76 eV LAr here); photons at that
+// energy then use these constants instead of the property vectors.
+
+struct MaterialOpticalConstants {
+  G4bool   valid;          // material has optical properties
+  G4double rindex;
+  G4double absLength;      // DBL_MAX if no ABSLENGTH
+  G4double rayleighLength; // DBL_MAX if no RAYLEIGH
+  G4double groupVelocity;
+};
+
+class OpticalConstants
+{
+public:
+  OpticalConstants();
+  ~OpticalConstants();
+
+  // (re)evaluate the constants from the current material table
+  void Resolve();
+
+  void   SetActive(G4bool val) {fActive = val;}
+  G4bool IsActive() const      {return fActive && fEnergy > 0.;}
+
+  G4double GetEnergy() const {return fEnergy;}
+
+  G4bool IsLine(G4double energy) const
+  { return IsActive() && std::fabs(energy - fEnergy) <= 1.e-6*fEnergy; }
+
+  const MaterialOpticalConstants& Get(const G4Material*);
+
+private:
+  G4bool   fActive;
+  G4double fEnergy;
+  std::vector<MaterialOpticalConstants> fConstants; // by material index
+};
+
+#endif
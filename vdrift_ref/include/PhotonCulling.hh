@@ -0,0 +1,64 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef PhotonCulling_h
+#define PhotonCulling_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4MaterialPropertyVector.hh"
+
+class G4Track;
+class DetectorConstruction;
+class PhotonCullingMessenger;
+
+// Geometric reachability test for optical photons, done at birth and after
+// each reflection. If the straight line from the photon does not cross any
+// window plane before it leaves the box bounded by the cryostat walls and
+// the anode/cathode planes, the photon has to survive absorption in LAr and
+// a reflection off that face to go on. When that probability is below
+// fThreshold the photon is killed, or played at roulette with survival
+// probability fSurvival (weight 1/fSurvival) to keep the estimate unbiased.
+
+class PhotonCulling
+{
+public:
+  PhotonCulling(DetectorConstruction*);
+  ~PhotonCulling();
+
+  // returns true if the track was killed
+  G4bool Apply(G4Track*);
+
+  // survival probability to the first absorbing face, -1 if a window
+  // plane can be reached first or the photon is outside the active box
+  G4double Survival(const G4ThreeVector& pos, const G4ThreeVector& dir,
+                    G4double energy);
+
+  void SetActive(G4bool val)       {fActive = val;}
+  void SetThreshold(G4double val)  {fThreshold = val;}
+  void SetRoulette(G4bool val)     {fRoulette = val;}
+  void SetSurvival(G4double val)   {fSurvival = val;}
+
+  G4bool IsActive() const {return fActive;}
+
+private:
+  void Initialise();
+
+  DetectorConstruction*   fDetector;
+  PhotonCullingMessenger* fMessenger;
+
+  G4bool   fActive;
+  G4double fThreshold;
+  G4bool   fRoulette;
+  G4double fSurvival;
+
+  G4bool   fInitialised;
+  G4MaterialPropertyVector* fAbsLength;
+  G4MaterialPropertyVector* fAnodeReflectivity;
+  G4MaterialPropertyVector* fCryostatReflectivity;
+};
+
+#endif
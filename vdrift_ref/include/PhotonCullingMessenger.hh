@@ -0,0 +1,36 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef PhotonCullingMessenger_h
+#define PhotonCullingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PhotonCulling;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+
+class PhotonCullingMessenger: public G4UImessenger
+{
+  public:
+    PhotonCullingMessenger(PhotonCulling*);
+   ~PhotonCullingMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    PhotonCulling*             fCulling;
+
+    G4UIdirectory*             fCullingDir;
+    G4UIcmdWithABool*          fActiveCmd;
+    G4UIcmdWithADouble*        fThresholdCmd;
+    G4UIcmdWithABool*          fRouletteCmd;
+    G4UIcmdWithADouble*        fSurvivalCmd;
+};
+
+#endif
@@ -0,0 +1,52 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef PhotonRoulette_h
+#define PhotonRoulette_h 1
+
+#include "globals.hh"
+
+class G4Track;
+class DetectorConstruction;
+class PhotonRouletteMessenger;
+
+// Russian roulette for long-lived optical photons. Applied at each
+// reflection once the track has reflected fMinReflections times, travelled
+// fMinPathLength and is further than fMinWindowDistance from every window
+// plane: the photon is killed with probability fKillProbability, survivors
+// get weight 1/(1-p).
+
+class PhotonRoulette
+{
+public:
+  PhotonRoulette(DetectorConstruction*);
+  ~PhotonRoulette();
+
+  // returns true if the track was killed
+  G4bool Apply(G4Track*, G4int nReflections);
+
+  G4double DistanceToWindowPlane(const G4Track*) const;
+
+  void SetActive(G4bool val)            {fActive = val;}
+  void SetKillProbability(G4double val) {fKillProbability = val;}
+  void SetMinReflections(G4int val)     {fMinReflections = val;}
+  void SetMinPathLength(G4double val)   {fMinPathLength = val;}
+  void SetMinWindowDistance(G4double val) {fMinWindowDistance = val;}
+
+  G4bool IsActive() const {return fActive;}
+
+private:
+  DetectorConstruction*    fDetector;
+  PhotonRouletteMessenger* fMessenger;
+
+  G4bool   fActive;
+  G4double fKillProbability;
+  G4int    fMinReflections;
+  G4double fMinPathLength;
+  G4double fMinWindowDistance;
+};
+
+#endif
@@ -0,0 +1,39 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef PhotonRouletteMessenger_h
+#define PhotonRouletteMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PhotonRoulette;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+class PhotonRouletteMessenger: public G4UImessenger
+{
+  public:
+    PhotonRouletteMessenger(PhotonRoulette*);
+   ~PhotonRouletteMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    PhotonRoulette*            fRoulette;
+
+    G4UIdirectory*             fRouletteDir;
+    G4UIcmdWithABool*          fActiveCmd;
+    G4UIcmdWithADouble*        fKillProbCmd;
+    G4UIcmdWithAnInteger*      fMinReflCmd;
+    G4UIcmdWithADoubleAndUnit* fMinPathCmd;
+    G4UIcmdWithADoubleAndUnit* fMinDistCmd;
+};
+
+#endif
@@ -2,11 +2,17 @@
 #define PhysicsList_h 1
 
 #include "globals.hh"
-#include "G4VUserPhysicsList.hh"
+#include "G4VModularPhysicsList.hh"
 
 class PhysicsListMessenger;
+class G4VPhysicsConstructor;
+class G4Scintillation;
+class FastOpBoundaryProcess;
+class OpticalConstants;
+class FastOpRayleigh;
+class PhysicsTableCache;
 
-class PhysicsList : public G4VUserPhysicsList
+class PhysicsList : public G4VModularPhysicsList
 {
   public:
     PhysicsList();
@@ -21,14 +27,68 @@ class PhysicsList : public G4VUserPhysicsList
     void ConstructDecay();
     void ConstructEM();
     void ConstructOp();
+    void AddParameterisation();
+
+    // EM physics: "local" (ConstructEM, default), "standard", "livermore",
+    // "penelope" (PhysListEm*) or the Geant4 constructors emstandard_opt0,
+    // emstandard_opt3, emstandard_opt4, emlivermore and empenelope
+    void AddPhysicsList(const G4String& name);
+    const G4String& GetEmName() const {return fEmName;}
 
     void SetVerbose(G4int);
     void SetNbOfPhotonsCerenkov(G4int);
+
+    // Global downscaling of the scintillation/Cerenkov yield; surviving
+    // photons carry weight 1/f (see TrackingAction)
+    void SetOpticalYieldScale(G4double);
+    G4double GetOpticalYieldScale() const {return fOpticalYieldScale;}
+    // factor of the scintillation process of this thread
+    G4double GetScintillationYieldFactor() const;
+
+    // The optical processes are per thread and the settings shared, while
+    // commands in Idle run on the master only: each thread takes the
+    // settings at the start of a run (RunAction)
+    void ApplyOpticalSettings();
+
+    // Direct reflect-or-absorb handling of the dielectric_metal skins
+    void SetFastBoundary(G4bool);
+
+    // Constant optical properties for photons at the scintillation line
+    void SetMonochromatic(G4bool);
+    OpticalConstants* GetOpticalConstants() const {return fOpticalConstants;}
+
+    // Tabulated (rejection-free) Rayleigh angular sampling
+    void SetFastRayleigh(G4bool);
+
+    // Optical photons made and tracked only inside the cryostat; those
+    // reaching the shell or the LAr of the world are killed (OpRegionKill)
+    void SetCryostatOnly(G4bool);
+
+    // Physics tables stored in and retrieved from dir (PhysicsTableCache);
+    // empty or "none" disables
+    void SetPhysicsTableCache(const G4String& dir);
+
+    // Options the physics tables depend on, part of the cache key; the
+    // optical switches above change no table
+    G4String GetConfiguration() const;
  
   private:
     G4int                fVerboseLebel;
     PhysicsListMessenger* fMessenger;
+    G4String             fEmName;
+    G4VPhysicsConstructor* fEmPhysicsList;
     G4int fMaxNumPhotonStep;
+    G4double fOpticalYieldScale;
+    G4bool   fFastBoundary;
+    G4bool   fMonochromatic;
+    G4bool   fFastRayleigh;
+    G4bool   fCryostatOnly;
+    PhysicsTableCache* fTableCache;
+
+    static G4ThreadLocal G4Scintillation* fScintillationProcess;
+    static G4ThreadLocal FastOpBoundaryProcess* fBoundaryProcess;
+    static G4ThreadLocal OpticalConstants* fOpticalConstants;
+    static G4ThreadLocal FastOpRayleigh* fRayleighProcess;
 };
 
 #endif /* PhysicsList_h */
@@ -12,6 +12,8 @@
 
 class PhysicsList;
 class G4UIdirectory;
+class G4UIcmdWithADouble;
+class G4UIcmdWithABool;
 class G4UIcmdWithAString;
 
 class PhysicsListMessenger: public G4UImessenger
@@ -28,7 +30,13 @@ class PhysicsListMessenger: public G4UImessenger
     PhysicsList*               fPhysicsList;
     
     G4UIdirectory*             fPhysDir;    
-    G4UIcmdWithAString*        fListCmd;    
+    G4UIcmdWithADouble*        fYieldScaleCmd;
+    G4UIcmdWithABool*          fFastBoundaryCmd;
+    G4UIcmdWithABool*          fMonoCmd;
+    G4UIcmdWithABool*          fFastRayleighCmd;
+    G4UIcmdWithABool*          fCryostatOnlyCmd;
+    G4UIcmdWithAString*        fTableCacheCmd;
+    G4UIcmdWithAString*        fListCmd;
 };
 
 #endif
@@ -0,0 +1,45 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "globals.hh"
+#include "G4VStateDependent.hh"
+
+class PhysicsList;
+
+// Physics tables kept between jobs in <dir>/<key>/, the key being a hash
+// of the Geant4 version, the physics configuration, the production cuts
+// of every region and the material data the tables are built from.
+// Prepare (from PhysicsList::SetCuts) has the tables of an existing entry
+// retrieved; otherwise they are built as usual and stored when the first
+// run closes the geometry. Geant4 rebuilds whatever it cannot retrieve.
+
+class PhysicsTableCache : public G4VStateDependent
+{
+public:
+  PhysicsTableCache(PhysicsList*);
+  virtual ~PhysicsTableCache();
+
+  void SetDirectory(const G4String& dir) {fDirectory = dir;}
+  const G4String& GetDirectory() const   {return fDirectory;}
+
+  G4String GetKey() const;
+  void Prepare();
+
+  virtual G4bool Notify(G4ApplicationState requestedState);
+
+private:
+  void Store();
+
+  PhysicsList* fPhysics;
+  G4String     fDirectory;
+  G4String     fEntry;
+  G4bool       fStore;
+};
+
+#endif
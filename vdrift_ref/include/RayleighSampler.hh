@@ -0,0 +1,45 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef RayleighSampler_h
+#define RayleighSampler_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+// Rayleigh scattering of a polarised photon without rejection. The new
+// direction k' makes an angle with the old polarisation e whose cosine u
+// has density 3/4(1-u^2); u is read from a tabulated inverse CDF, the
+// azimuth about e is uniform and the new polarisation is the component
+// of e normal to k'. This is the distribution G4OpRayleigh reaches with
+// its accept/reject loop. Three uniform numbers are used per scatter.
+
+class RayleighSampler
+{
+public:
+  RayleighSampler(G4int nBins = 4096);
+  ~RayleighSampler();
+
+  // u for a uniform xi in [0,1)
+  G4double SampleCosine(G4double xi) const;
+
+  void Scatter(const G4ThreeVector& dir, const G4ThreeVector& pol,
+               const G4double* rand, G4ThreeVector& newDir,
+               G4ThreeVector& newPol) const;
+
+  // Same update over n photons stored as separate component arrays,
+  // updated in place; rand holds 3n uniform numbers
+  void ScatterBatch(G4int n, G4double* dx, G4double* dy, G4double* dz,
+                    G4double* px, G4double* py, G4double* pz,
+                    const G4double* rand) const;
+
+private:
+  G4int                 fNBins;
+  std::vector<G4double> fTable;
+};
+
+#endif
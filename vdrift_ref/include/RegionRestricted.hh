@@ -0,0 +1,46 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef RegionRestricted_h
+#define RegionRestricted_h 1
+
+#include "OpRegionKill.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+
+// Photon generation process (G4Scintillation, G4Cerenkov) that makes no
+// photons outside the cryostat while OpRegionKill is active; the step
+// limits of the wrapped process are unchanged
+
+template <class Process>
+class RegionRestricted : public Process
+{
+public:
+  RegionRestricted(const G4String& processName) : Process(processName) {}
+  virtual ~RegionRestricted() {}
+
+  virtual G4VParticleChange* PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
+  {
+    if(OpRegionKill::IsActive() &&
+       OpRegionKill::IsOutside(aStep.GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume())){
+      this->aParticleChange.Initialize(aTrack);
+      return &this->aParticleChange;
+    }
+    return Process::PostStepDoIt(aTrack, aStep);
+  }
+
+  virtual G4VParticleChange* AtRestDoIt(const G4Track& aTrack, const G4Step& aStep)
+  {
+    if(OpRegionKill::IsActive() && OpRegionKill::IsOutside(aTrack.GetVolume()->GetLogicalVolume())){
+      this->aParticleChange.Initialize(aTrack);
+      return &this->aParticleChange;
+    }
+    return Process::AtRestDoIt(aTrack, aStep);
+  }
+};
+
+#endif
@@ -19,14 +19,52 @@ class B1Run : public G4Run
     virtual void Merge(const G4Run*);
     
     void AddEdep (G4double edep); 
+    void AddDetection (G4double weight);
+    void AddRouletteKill (G4double weight);
+    void AddRouletteWeight (G4double dweight);
+    void AddCulled (G4double weight);
+    void AddCullingWeight (G4double dweight);
+    void AddNavigationStep (G4int candidates);
 
     // get methods
     G4double GetEdep()  const { return fEdep; }
     G4double GetEdep2() const { return fEdep2; }
 
+    // optical photons reaching a window: entries, sum of weights and
+    // sum of squared weights (variance of the weighted sum)
+    G4int    GetNDetected()   const { return fNDetected; }
+    G4double GetDetWeight()   const { return fDetWeight; }
+    G4double GetDetWeight2()  const { return fDetWeight2; }
+
+    // optical photon roulette: killed tracks, weight they carried and
+    // weight given to the survivors
+    G4int    GetNRouletteKilled()    const { return fNRouletteKilled; }
+    G4double GetRouletteKilledWeight() const { return fRouletteKilledWeight; }
+    G4double GetRouletteAddedWeight()  const { return fRouletteAddedWeight; }
+
+    // reachability culling: same bookkeeping as the roulette
+    G4int    GetNCulled()          const { return fNCulled; }
+    G4double GetCulledWeight()     const { return fCulledWeight; }
+    G4double GetCullingAddedWeight() const { return fCullingAddedWeight; }
+
+    // navigation statistics: steps and daughters tested in their voxels
+    G4long   GetNNavSteps()        const { return fNNavSteps; }
+    G4double GetNavCandidates()    const { return fNavCandidates; }
+
   private:
     G4double  fEdep;
     G4double  fEdep2;
+    G4int     fNDetected;
+    G4double  fDetWeight;
+    G4double  fDetWeight2;
+    G4int     fNRouletteKilled;
+    G4double  fRouletteKilledWeight;
+    G4double  fRouletteAddedWeight;
+    G4int     fNCulled;
+    G4double  fCulledWeight;
+    G4double  fCullingAddedWeight;
+    G4long    fNNavSteps;
+    G4double  fNavCandidates;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
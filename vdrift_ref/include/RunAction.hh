@@ -12,14 +12,17 @@
 #include "DetectorConstruction.hh"
 
 class G4Run;
+class RunActionMessenger;
+class PhysicsList;
 
 class RunAction : public G4UserRunAction
 {
 public:
   
-  RunAction(DetectorConstruction*);
+  RunAction(DetectorConstruction*, PhysicsList* = 0);
   ~RunAction();
 
+  G4Run* GenerateRun();
   void BeginOfRunAction(const G4Run*);
   void EndOfRunAction(const G4Run*);
     
@@ -29,12 +32,19 @@ public:
   G4int GetNumEvent(){return fNumEvent;}
   void SetNumEvent(G4int i){fNumEvent = i;}
 
+  void   SetRecordPhotons(G4bool val) {fRecordPhotons = val;}
+  G4bool GetRecordPhotons() const     {return fRecordPhotons;}
+
 private:
 
   DetectorConstruction* fDetector;    
+  PhysicsList*          fPhysics;
 
   G4int fSaveRndm;
   G4int fNumEvent;
+  G4bool fRecordPhotons;
+
+  RunActionMessenger* fMessenger;
 
 };
 
@@ -0,0 +1,32 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef RunActionMessenger_h
+#define RunActionMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class RunAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+
+class RunActionMessenger: public G4UImessenger
+{
+  public:
+    RunActionMessenger(RunAction*);
+   ~RunActionMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    RunAction*            fRunAction;
+
+    G4UIdirectory*        fRunDir;
+    G4UIcmdWithABool*     fRecordCmd;
+};
+
+#endif
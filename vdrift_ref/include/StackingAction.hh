@@ -0,0 +1,64 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+class StackingActionMessenger;
+class PhysicsList;
+class TrackingAction;
+class SteppingAction;
+class BoxTracer;
+
+// Optical photons go to the waiting stack, so the charged shower of an
+// event is tracked first and the photons follow as a single batch.
+// The batch can be dropped or downsampled (survivors get weight 1/f).
+// With the box tracer on, line photons born in the LAr box bypass the
+// navigator and are traced in packets over a box export of the geometry.
+
+class StackingAction : public G4UserStackingAction
+{
+public:
+  StackingAction(PhysicsList*, TrackingAction*, SteppingAction*);
+  virtual ~StackingAction();
+
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*);
+  virtual void NewStage();
+  virtual void PrepareNewEvent();
+
+  void SetDeferPhotons(G4bool val)     {fDeferPhotons = val;}
+  void SetDropPhotons(G4bool val)      {fDropPhotons = val;}
+  void SetPhotonFraction(G4double val) {fPhotonFraction = val;}
+  void SetVerbose(G4int val)           {fVerbose = val;}
+  void SetBoxTracer(G4bool val)        {fUseTracer = val;}
+
+private:
+  G4bool BuildScene(G4double energy);
+  void   TraceBatch();
+
+  StackingActionMessenger* fMessenger;
+  PhysicsList*             fPhysics;
+  TrackingAction*          fTracking;
+  SteppingAction*          fStepping;
+  BoxTracer*               fTracer;
+  G4int                    fSceneBuild;   // DetectorConstruction build it was made from
+
+  G4bool   fDeferPhotons;
+  G4bool   fDropPhotons;
+  G4double fPhotonFraction;
+  G4int    fVerbose;
+  G4bool   fUseTracer;
+  G4bool   fSceneFailed;
+
+  G4int    fNPhotons;
+  G4int    fNSampledOut;
+  G4int    fNTraced;
+};
+
+#endif
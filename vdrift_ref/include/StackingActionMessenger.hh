@@ -0,0 +1,38 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef StackingActionMessenger_h
+#define StackingActionMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class StackingAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+
+class StackingActionMessenger: public G4UImessenger
+{
+  public:
+    StackingActionMessenger(StackingAction*);
+   ~StackingActionMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    StackingAction*        fStacking;
+
+    G4UIdirectory*         fStackDir;
+    G4UIcmdWithABool*      fDeferCmd;
+    G4UIcmdWithABool*      fDropCmd;
+    G4UIcmdWithADouble*    fFractionCmd;
+    G4UIcmdWithAnInteger*  fVerboseCmd;
+    G4UIcmdWithABool*      fTracerCmd;
+};
+
+#endif
@@ -13,18 +13,47 @@
 #include "DetectorConstruction.hh"
 #include <string>
 
+class PhotonRoulette;
+class PhotonCulling;
+class FastOpBoundaryProcess;
+class G4OpBoundaryProcess;
+class G4Material;
+class G4Track;
+
 class SteppingAction : public G4UserSteppingAction
 {
 public:
-  SteppingAction(RunAction* ,DetectorConstruction*);
+  SteppingAction(RunAction* ,DetectorConstruction*, PhotonRoulette*, PhotonCulling*);
   ~SteppingAction();
   
   void UserSteppingAction(const G4Step*);
-  std::pair<int,int> VolumeCode(std::string name); 
+  static std::pair<int,int> VolumeCode(std::string name); 
+
+  // photon continuing across a periodic end of the reduced geometry
+  static G4bool IsPeriodicImage(const G4Track*);
   
 private:
+  G4bool WrapPeriodic(const G4Step*);
+  void PhotonHistoryStep(const G4Step*);
+  void OpticalPhotonStep(const G4Step*);
+  G4int SurfaceClass(const G4Step*) const;
+  void RecordPhoton(const G4Step*, G4int vol, G4double weight);
+
   RunAction*            fRun;
   DetectorConstruction* fDetector;
+  PhotonRoulette*       fRoulette;
+  PhotonCulling*        fCulling;
+  // boundary process of the photons, looked up once: the fast one if
+  // registered, otherwise the plain G4OpBoundaryProcess
+  FastOpBoundaryProcess* fFastBoundary;
+  G4OpBoundaryProcess*  fBoundary;
+  G4bool                fBoundaryLookedUp;
+  G4int                 fNReflections; // of the photon being tracked
+  // history of the photon being tracked, written out on detection
+  G4Material*           fLAr;
+  G4double              fPathLength;
+  G4int                 fNRayleigh;
+  G4int                 fNSurface[3];  // Anode, FC, Cryostat skins
   std::map<std::string, int> imap;
   std::map<std::string, int>::iterator p;
   int idx;
@@ -0,0 +1,33 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#ifndef TrackingAction_h
+#define TrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+class PhysicsList;
+class PhotonCulling;
+
+class TrackingAction : public G4UserTrackingAction
+{
+public:
+  TrackingAction(PhysicsList*, PhotonCulling*);
+  ~TrackingAction();
+
+  void PreUserTrackingAction(const G4Track*);
+
+  // also used for photons the stacking action hands to the box tracer
+  void ApplyYieldScale(G4Track*);
+
+private:
+
+  PhysicsList*   fPhysics;
+  PhotonCulling* fCulling;
+};
+
+#endif
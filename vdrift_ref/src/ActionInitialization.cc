@@ -3,11 +3,17 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "SteppingAction.hh"
+#include "TrackingAction.hh"
+#include "StackingAction.hh"
+#include "PhotonRoulette.hh"
+#include "PhotonCulling.hh"
 #include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
 
-ActionInitialization::ActionInitialization(DetectorConstruction* detConstruction, double x, double y, double z, int pdgcode, double KE)
+ActionInitialization::ActionInitialization(DetectorConstruction* detConstruction, PhysicsList* physics, double x, double y, double z, int pdgcode, double KE)
  : G4VUserActionInitialization(),
-   fDetectorConstruction(detConstruction)
+   fDetectorConstruction(detConstruction),
+   fPhysicsList(physics)
 {x0=x; y0=y; z0=z; pdgcode0=pdgcode; KE0=KE;}
 
 ActionInitialization::~ActionInitialization()
@@ -22,11 +28,19 @@ void ActionInitialization::Build() const
 {
   SetUserAction(new PrimaryGeneratorAction(x0,y0,z0,pdgcode0,KE0));
   
-  RunAction* runAction= new RunAction(fDetectorConstruction);
+  RunAction* runAction= new RunAction(fDetectorConstruction,fPhysicsList);
   SetUserAction(runAction);
 
   SetUserAction(new EventAction(runAction));
+
+  PhotonCulling* culling = new PhotonCulling(fDetectorConstruction);
+  TrackingAction* trackingAction = new TrackingAction(fPhysicsList,culling);
+  SetUserAction(trackingAction);
   
-  SetUserAction(new SteppingAction(runAction,fDetectorConstruction));
+  PhotonRoulette* roulette = new PhotonRoulette(fDetectorConstruction);
+  SteppingAction* steppingAction = new SteppingAction(runAction,fDetectorConstruction,roulette,culling);
+  SetUserAction(steppingAction);
+
+  SetUserAction(new StackingAction(fPhysicsList,trackingAction,steppingAction));
 }  
 
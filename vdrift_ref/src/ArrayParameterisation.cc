@@ -0,0 +1,46 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "ArrayParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VTouchable.hh"
+
+ArrayParameterisation::ArrayParameterisation()
+:G4VPVParameterisation(),fScoring(0)
+{}
+
+ArrayParameterisation::~ArrayParameterisation()
+{}
+
+void ArrayParameterisation::AddCopy(const G4ThreeVector& pos, G4RotationMatrix* rot, G4int channel)
+{
+  fPosition.push_back(pos);
+  fRotation.push_back(rot);
+  fChannel.push_back(channel);
+}
+
+void ArrayParameterisation::Shift(const G4ThreeVector& offset)
+{
+  for(size_t i=0; i<fPosition.size(); i++) fPosition[i] += offset;
+}
+
+void ArrayParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+  physVol->SetTranslation(fPosition[copyNo]);
+  physVol->SetRotation(fRotation[copyNo]);
+}
+
+G4int ArrayParameterisation::Channel(const G4VTouchable* touchable)
+{
+  if(!touchable || touchable->GetHistoryDepth() < 1) return -1;
+  G4VPhysicalVolume* copy = touchable->GetVolume(1);
+  if(!copy || !copy->IsParameterised()) return -1;
+  ArrayParameterisation* param = dynamic_cast<ArrayParameterisation*>(copy->GetParameterisation());
+  if(!param || !param->fScoring || touchable->GetVolume(0)->GetLogicalVolume() != param->fScoring) return -1;
+  return param->GetChannel(touchable->GetReplicaNumber(1));
+}
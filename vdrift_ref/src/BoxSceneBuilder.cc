@@ -0,0 +1,209 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "BoxSceneBuilder.hh"
+#include "SteppingAction.hh"
+#include "ArrayParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Box.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4UnionSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4Material.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4OpticalSurface.hh"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace {
+  TracerBox TransformedBox(const G4ThreeVector& lo, const G4ThreeVector& hi,
+                           const G4AffineTransform& t)
+  {
+    TracerBox box;
+    for(G4int a=0; a<3; a++){ box.lo[a] = DBL_MAX; box.hi[a] = -DBL_MAX; }
+    for(G4int c=0; c<8; c++){
+      G4ThreeVector corner((c & 1) ? hi.x() : lo.x(), (c & 2) ? hi.y() : lo.y(),
+                           (c & 4) ? hi.z() : lo.z());
+      G4ThreeVector p = t.TransformPoint(corner);
+      for(G4int a=0; a<3; a++){
+        box.lo[a] = std::min(box.lo[a], p[a]);
+        box.hi[a] = std::max(box.hi[a], p[a]);
+      }
+    }
+    box.code = -1;
+    box.reflectivity = 0.;
+    return box;
+  }
+
+  // a minus b as up to six boxes
+  void SubtractBox(const TracerBox& a, const TracerBox& b, std::vector<TracerBox>& out)
+  {
+    for(G4int k=0; k<3; k++){
+      if(b.hi[k] <= a.lo[k] || b.lo[k] >= a.hi[k]){ out.push_back(a); return; }
+    }
+    TracerBox rest = a;
+    for(G4int k=0; k<3; k++){
+      if(b.lo[k] > rest.lo[k]){
+        TracerBox piece = rest;
+        piece.hi[k] = b.lo[k];
+        out.push_back(piece);
+        rest.lo[k] = b.lo[k];
+      }
+      if(b.hi[k] < rest.hi[k]){
+        TracerBox piece = rest;
+        piece.lo[k] = b.hi[k];
+        out.push_back(piece);
+        rest.hi[k] = b.hi[k];
+      }
+    }
+  }
+}
+
+BoxSceneBuilder::BoxSceneBuilder(SteppingAction* stepping)
+:fStepping(stepping),fNApproximated(0),fEnergy(0.),fLAr(0)
+{}
+
+BoxSceneBuilder::~BoxSceneBuilder()
+{}
+
+void BoxSceneBuilder::AppendBoxes(G4VSolid* solid, const G4AffineTransform& t,
+                                  std::vector<TracerBox>& out)
+{
+  if(G4Box* box = dynamic_cast<G4Box*>(solid)){
+    G4ThreeVector half(box->GetXHalfLength(), box->GetYHalfLength(), box->GetZHalfLength());
+    out.push_back(TransformedBox(-half, half, t));
+    return;
+  }
+  if(G4DisplacedSolid* displaced = dynamic_cast<G4DisplacedSolid*>(solid)){
+    AppendBoxes(displaced->GetConstituentMovedSolid(), displaced->GetDirectTransform()*t, out);
+    return;
+  }
+  if(G4SubtractionSolid* subtraction = dynamic_cast<G4SubtractionSolid*>(solid)){
+    std::vector<TracerBox> kept, removed;
+    AppendBoxes(subtraction->GetConstituentSolid(0), t, kept);
+    AppendBoxes(subtraction->GetConstituentSolid(1), t, removed);
+    for(size_t r=0; r<removed.size(); r++){
+      std::vector<TracerBox> pieces;
+      for(size_t k=0; k<kept.size(); k++) SubtractBox(kept[k], removed[r], pieces);
+      kept.swap(pieces);
+    }
+    out.insert(out.end(), kept.begin(), kept.end());
+    return;
+  }
+  if(G4UnionSolid* uni = dynamic_cast<G4UnionSolid*>(solid)){
+    AppendBoxes(uni->GetConstituentSolid(0), t, out);
+    AppendBoxes(uni->GetConstituentSolid(1), t, out);
+    return;
+  }
+
+  G4VisExtent extent = solid->GetExtent();
+  out.push_back(TransformedBox(G4ThreeVector(extent.GetXmin(), extent.GetYmin(), extent.GetZmin()),
+                               G4ThreeVector(extent.GetXmax(), extent.GetYmax(), extent.GetZmax()), t));
+  fNApproximated++;
+}
+
+G4double BoxSceneBuilder::SkinReflectivity(const G4LogicalVolume* lv, G4double energy,
+                                           G4bool& found) const
+{
+  found = false;
+  G4LogicalSkinSurface* skin = G4LogicalSkinSurface::GetSurface(lv);
+  if(!skin) return 0.;
+  G4OpticalSurface* surface = dynamic_cast<G4OpticalSurface*>(skin->GetSurfaceProperty());
+  if(!surface) return 0.;
+  found = true;
+  G4MaterialPropertiesTable* mpt = surface->GetMaterialPropertiesTable();
+  G4MaterialPropertyVector* r = mpt ? mpt->GetProperty("REFLECTIVITY") : 0;
+  return r ? r->Value(energy) : 1.;
+}
+
+void BoxSceneBuilder::AppendDaughters(const G4LogicalVolume* mother, const G4AffineTransform& motherT,
+                                      G4double motherReflectivity, const G4LogicalVolume* scoring,
+                                      G4int channel, BoxScene& scene)
+{
+  G4bool found;
+  for(G4int i=0; i<mother->GetNoDaughters(); i++){
+    G4VPhysicalVolume* daughter = mother->GetDaughter(i);
+    G4LogicalVolume* lv = daughter->GetLogicalVolume();
+
+    // entering a daughter: its own skin first, then the mother's
+    G4double reflectivity = SkinReflectivity(lv, fEnergy, found);
+    if(!found) reflectivity = motherReflectivity;
+
+    G4VPVParameterisation* param = daughter->GetParameterisation();
+    ArrayParameterisation* array = dynamic_cast<ArrayParameterisation*>(param);
+    G4int nCopies = param ? daughter->GetMultiplicity() : 1;
+    for(G4int copy=0; copy<nCopies; copy++){
+      if(param) param->ComputeTransformation(copy, daughter);
+      G4AffineTransform t =
+        G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation())*motherT;
+
+      // LAr containers and modules: descend, the copy number of an array
+      // gives the channel of its scoring volume
+      if(lv->GetMaterial() == fLAr){
+        if(array && array->GetScoringVolume())
+          AppendDaughters(lv, t, reflectivity, array->GetScoringVolume(), array->GetChannel(copy), scene);
+        else
+          AppendDaughters(lv, t, reflectivity, scoring, channel, scene);
+        continue;
+      }
+
+      G4int code;
+      if(scoring) code = (lv == scoring) ? channel : -1;
+      else code = SteppingAction::VolumeCode(daughter->GetName()).first;
+      if(code < 5) code = -1;
+
+      std::vector<TracerBox> pieces;
+      AppendBoxes(lv->GetSolid(), t, pieces);
+      for(size_t k=0; k<pieces.size(); k++){
+        pieces[k].code = code;
+        pieces[k].reflectivity = reflectivity;
+        scene.boxes.push_back(pieces[k]);
+      }
+    }
+  }
+}
+
+G4bool BoxSceneBuilder::Build(const G4VPhysicalVolume* world, G4double energy, BoxScene& scene)
+{
+  fNApproximated = 0;
+  scene.periodicZ = false;
+  scene.boxes.clear();
+
+  const G4LogicalVolume* worldLV = world->GetLogicalVolume();
+  G4VPhysicalVolume* cryostat = 0;
+  for(G4int i=0; i<worldLV->GetNoDaughters(); i++)
+    if(worldLV->GetDaughter(i)->GetName() == "Cryostat") cryostat = worldLV->GetDaughter(i);
+  if(!cryostat) return false;
+
+  G4LogicalVolume* cryoLV = cryostat->GetLogicalVolume();
+  G4Box* cryoBox = dynamic_cast<G4Box*>(cryoLV->GetSolid());
+  if(!cryoBox) return false;
+
+  G4AffineTransform cryoT(cryostat->GetRotation(), cryostat->GetTranslation());
+  G4ThreeVector half(cryoBox->GetXHalfLength(), cryoBox->GetYHalfLength(), cryoBox->GetZHalfLength());
+  TracerBox volume = TransformedBox(-half, half, cryoT);
+  for(G4int a=0; a<3; a++){ scene.lo[a] = volume.lo[a]; scene.hi[a] = volume.hi[a]; }
+
+  G4bool found;
+  G4double cryoReflectivity = SkinReflectivity(cryoLV, energy, found);
+  scene.wallReflectivity = cryoReflectivity;
+
+  G4Material* lAr = cryoLV->GetMaterial();
+  G4MaterialPropertiesTable* mpt = lAr->GetMaterialPropertiesTable();
+  G4MaterialPropertyVector* abs = mpt ? mpt->GetProperty("ABSLENGTH") : 0;
+  G4MaterialPropertyVector* ray = mpt ? mpt->GetProperty("RAYLEIGH") : 0;
+  scene.absLength = abs ? abs->Value(energy) : DBL_MAX;
+  scene.rayleighLength = ray ? ray->Value(energy) : DBL_MAX;
+
+  fEnergy = energy;
+  fLAr = lAr;
+  AppendDaughters(cryoLV, cryoT, cryoReflectivity, 0, -1, scene);
+  return true;
+}
@@ -0,0 +1,362 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "BoxTracer.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+  struct CentroidLess {
+    const std::vector<TracerBox>* boxes;
+    G4int axis;
+    bool operator()(G4int a, G4int b) const {
+      const TracerBox& ba = (*boxes)[a];
+      const TracerBox& bb = (*boxes)[b];
+      return ba.lo[axis]+ba.hi[axis] < bb.lo[axis]+bb.hi[axis];
+    }
+  };
+}
+
+BoxTracer::BoxTracer()
+:fHasScene(false),fEpsilon(1.e-3*mm),fMaxSteps(100000),fNSteps(0)
+{}
+
+BoxTracer::~BoxTracer()
+{}
+
+void BoxTracer::SetScene(const BoxScene& scene)
+{
+  fScene = scene;
+  fOrder.resize(fScene.boxes.size());
+  for(size_t i=0; i<fOrder.size(); i++) fOrder[i] = i;
+  fNodes.clear();
+  fNodes.reserve(2*fOrder.size()+1);
+  BuildNode(0, fOrder.size());
+  fHasScene = true;
+}
+
+G4int BoxTracer::BuildNode(G4int first, G4int count)
+{
+  Node node;
+  G4double clo[3], chi[3];
+  for(G4int a=0; a<3; a++){
+    node.lo[a] = clo[a] = DBL_MAX;
+    node.hi[a] = chi[a] = -DBL_MAX;
+  }
+  for(G4int k=first; k<first+count; k++){
+    const TracerBox& b = fScene.boxes[fOrder[k]];
+    for(G4int a=0; a<3; a++){
+      node.lo[a] = std::min(node.lo[a], b.lo[a]);
+      node.hi[a] = std::max(node.hi[a], b.hi[a]);
+      clo[a] = std::min(clo[a], b.lo[a]+b.hi[a]);
+      chi[a] = std::max(chi[a], b.lo[a]+b.hi[a]);
+    }
+  }
+  node.first = first;
+  node.count = count;
+  node.right = -1;
+
+  G4int index = fNodes.size();
+  fNodes.push_back(node);
+  if(count <= 4) return index;
+
+  // median split along the widest spread of box centres
+  G4int axis = 0;
+  for(G4int a=1; a<3; a++)
+    if(chi[a]-clo[a] > chi[axis]-clo[axis]) axis = a;
+  G4int half = count/2;
+  CentroidLess less = {&fScene.boxes, axis};
+  std::nth_element(fOrder.begin()+first, fOrder.begin()+first+half,
+                   fOrder.begin()+first+count, less);
+
+  fNodes[index].count = 0;
+  BuildNode(first, half);
+  G4int right = BuildNode(first+half, count-half);
+  fNodes[index].right = right;
+  return index;
+}
+
+G4bool BoxTracer::Contains(const G4ThreeVector& pos) const
+{
+  for(G4int a=0; a<3; a++)
+    if(pos[a] <= fScene.lo[a] || pos[a] >= fScene.hi[a]) return false;
+  return true;
+}
+
+void BoxTracer::AddPhoton(const G4ThreeVector& pos, const G4ThreeVector& dir,
+                          const G4ThreeVector& pol, G4double weight)
+{
+  fX.push_back(pos.x());  fY.push_back(pos.y());  fZ.push_back(pos.z());
+  fDx.push_back(dir.x()); fDy.push_back(dir.y()); fDz.push_back(dir.z());
+  fPx.push_back(pol.x()); fPy.push_back(pol.y()); fPz.push_back(pol.z());
+  fW.push_back(weight);
+  fAlive.push_back(1);
+}
+
+// Slab test of one box against every lane. Nodes pass when the ray
+// overlaps them before tBest; boxes pass when the ray enters them in
+// front of the origin and before tBest, tEntry then holds the distance.
+G4int BoxTracer::NodeMask(const G4double* lo, const G4double* hi, const Packet& p,
+                          G4double* tEntry, G4bool entry) const
+{
+#if defined(__AVX512F__)
+  __m512d tmin = _mm512_set1_pd(-DBL_MAX);
+  __m512d tmax = _mm512_loadu_pd(p.tBest);
+  for(G4int a=0; a<3; a++){
+    __m512d o = _mm512_loadu_pd(p.o[a]);
+    __m512d inv = _mm512_loadu_pd(p.inv[a]);
+    __m512d t1 = _mm512_mul_pd(_mm512_sub_pd(_mm512_set1_pd(lo[a]), o), inv);
+    __m512d t2 = _mm512_mul_pd(_mm512_sub_pd(_mm512_set1_pd(hi[a]), o), inv);
+    tmin = _mm512_max_pd(tmin, _mm512_min_pd(t1, t2));
+    tmax = _mm512_min_pd(tmax, _mm512_max_pd(t1, t2));
+  }
+  if(entry){
+    _mm512_storeu_pd(tEntry, tmin);
+    return _mm512_cmp_pd_mask(tmin, _mm512_set1_pd(fEpsilon), _CMP_GT_OQ) &
+           _mm512_cmp_pd_mask(tmin, tmax, _CMP_LE_OQ);
+  }
+  return _mm512_cmp_pd_mask(_mm512_max_pd(tmin, _mm512_setzero_pd()), tmax, _CMP_LE_OQ);
+#elif defined(__AVX2__)
+  __m256d tmin = _mm256_set1_pd(-DBL_MAX);
+  __m256d tmax = _mm256_loadu_pd(p.tBest);
+  for(G4int a=0; a<3; a++){
+    __m256d o = _mm256_loadu_pd(p.o[a]);
+    __m256d inv = _mm256_loadu_pd(p.inv[a]);
+    __m256d t1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(lo[a]), o), inv);
+    __m256d t2 = _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(hi[a]), o), inv);
+    tmin = _mm256_max_pd(tmin, _mm256_min_pd(t1, t2));
+    tmax = _mm256_min_pd(tmax, _mm256_max_pd(t1, t2));
+  }
+  if(entry){
+    _mm256_storeu_pd(tEntry, tmin);
+    return _mm256_movemask_pd(_mm256_and_pd(
+             _mm256_cmp_pd(tmin, _mm256_set1_pd(fEpsilon), _CMP_GT_OQ),
+             _mm256_cmp_pd(tmin, tmax, _CMP_LE_OQ)));
+  }
+  return _mm256_movemask_pd(
+           _mm256_cmp_pd(_mm256_max_pd(tmin, _mm256_setzero_pd()), tmax, _CMP_LE_OQ));
+#else
+  G4int mask = 0;
+  for(G4int l=0; l<kBoxTracerWidth; l++){
+    G4double tmin = -DBL_MAX, tmax = p.tBest[l];
+    for(G4int a=0; a<3; a++){
+      G4double t1 = (lo[a]-p.o[a][l])*p.inv[a][l];
+      G4double t2 = (hi[a]-p.o[a][l])*p.inv[a][l];
+      tmin = std::max(tmin, std::min(t1, t2));
+      tmax = std::min(tmax, std::max(t1, t2));
+    }
+    if(entry){
+      tEntry[l] = tmin;
+      if(tmin > fEpsilon && tmin <= tmax) mask |= 1 << l;
+    }else if(std::max(tmin, 0.) <= tmax){
+      mask |= 1 << l;
+    }
+  }
+  return mask;
+#endif
+}
+
+void BoxTracer::Traverse(Packet& p) const
+{
+  if(fNodes.empty()) return;
+
+  G4double tEntry[kBoxTracerWidth];
+  G4int stack[64];
+  G4int sp = 0;
+  stack[sp++] = 0;
+  while(sp > 0){
+    G4int index = stack[--sp];
+    const Node& node = fNodes[index];
+    if(!NodeMask(node.lo, node.hi, p, tEntry, false)) continue;
+
+    if(node.count > 0){
+      for(G4int k=node.first; k<node.first+node.count; k++){
+        const TracerBox& b = fScene.boxes[fOrder[k]];
+        G4int mask = NodeMask(b.lo, b.hi, p, tEntry, true);
+        for(G4int l=0; mask; l++, mask >>= 1){
+          if(!(mask & 1)) continue;
+          p.tBest[l] = tEntry[l];
+          p.hit[l] = fOrder[k];
+        }
+      }
+    }else{
+      stack[sp++] = node.right;
+      stack[sp++] = index+1;
+    }
+  }
+}
+
+G4int BoxTracer::HitFace(const TracerBox& b, G4int i, G4double& sign) const
+{
+  G4double pos[3] = {fX[i], fY[i], fZ[i]};
+  G4int axis = 0;
+  G4double best = DBL_MAX;
+  for(G4int a=0; a<3; a++){
+    G4double dlo = std::fabs(pos[a]-b.lo[a]);
+    G4double dhi = std::fabs(pos[a]-b.hi[a]);
+    if(dlo < best){ best = dlo; axis = a; sign = -1.; }
+    if(dhi < best){ best = dhi; axis = a; sign = 1.; }
+  }
+  return axis;
+}
+
+// absorb with probability 1-R, otherwise Lambertian about the normal
+// (axis, sign), polarisation updated as in G4OpBoundaryProcess
+G4bool BoxTracer::Reflect(G4int i, G4int axis, G4double sign, G4double reflectivity)
+{
+  if(G4UniformRand() > reflectivity){
+    Remove(i);
+    return false;
+  }
+
+  G4double cosTheta = std::sqrt(G4UniformRand());
+  G4double sinTheta = std::sqrt(1.-cosTheta*cosTheta);
+  G4double phi = twopi*G4UniformRand();
+
+  G4double newDir[3];
+  newDir[axis] = sign*cosTheta;
+  newDir[(axis+1)%3] = sinTheta*std::cos(phi);
+  newDir[(axis+2)%3] = sinTheta*std::sin(phi);
+
+  G4ThreeVector oldMomentum(fDx[i], fDy[i], fDz[i]);
+  G4ThreeVector newMomentum(newDir[0], newDir[1], newDir[2]);
+  G4ThreeVector facet = (newMomentum - oldMomentum).unit();
+  G4ThreeVector pol(fPx[i], fPy[i], fPz[i]);
+  pol = -pol + (2.*(pol*facet))*facet;
+
+  fDx[i] = newDir[0]; fDy[i] = newDir[1]; fDz[i] = newDir[2];
+  fPx[i] = pol.x();   fPy[i] = pol.y();   fPz[i] = pol.z();
+
+  G4double* pos[3] = {&fX[i], &fY[i], &fZ[i]};
+  *pos[axis] += sign*fEpsilon;
+  return true;
+}
+
+void BoxTracer::Remove(G4int i)
+{
+  fAlive[i] = 0;
+}
+
+void BoxTracer::Trace(std::vector<std::pair<G4int,G4double> >& hits)
+{
+  const G4int W = kBoxTracerWidth;
+  G4double muAbs = (fScene.absLength > 0. && fScene.absLength < DBL_MAX) ? 1./fScene.absLength : 0.;
+  G4double muRay = (fScene.rayleighLength > 0. && fScene.rayleighLength < DBL_MAX) ? 1./fScene.rayleighLength : 0.;
+  G4double mu = muAbs + muRay;
+
+  std::vector<G4int> active;
+  for(size_t i=0; i<fAlive.size(); i++) if(fAlive[i]) active.push_back(i);
+
+  G4double rand[3*kBoxTracerWidth];
+  G4double sx[kBoxTracerWidth], sy[kBoxTracerWidth], sz[kBoxTracerWidth];
+  G4double spx[kBoxTracerWidth], spy[kBoxTracerWidth], spz[kBoxTracerWidth];
+  G4int scattered[kBoxTracerWidth];
+
+  for(G4int generation=0; !active.empty() && generation<fMaxSteps; generation++){
+    for(size_t start=0; start<active.size(); start+=W){
+      Packet p;
+      p.n = std::min<size_t>(W, active.size()-start);
+      G4double sInt[kBoxTracerWidth], tExit[kBoxTracerWidth], exitSign[kBoxTracerWidth];
+      G4int exitAxis[kBoxTracerWidth];
+
+      CLHEP::HepRandom::getTheEngine()->flatArray(p.n, rand);
+      for(G4int l=0; l<W; l++){
+        if(l >= p.n){
+          p.index[l] = -1;
+          for(G4int a=0; a<3; a++){ p.o[a][l] = 0.; p.inv[a][l] = 1.; }
+          p.tBest[l] = -1.;
+          p.hit[l] = -1;
+          continue;
+        }
+        G4int i = active[start+l];
+        p.index[l] = i;
+        G4double o[3] = {fX[i], fY[i], fZ[i]};
+        G4double d[3] = {fDx[i], fDy[i], fDz[i]};
+
+        tExit[l] = DBL_MAX;
+        exitAxis[l] = 0;
+        exitSign[l] = 1.;
+        for(G4int a=0; a<3; a++){
+          // keep 1/d finite so the slab test never sees 0*inf
+          if(std::fabs(d[a]) < 1.e-12) d[a] = (d[a] < 0.) ? -1.e-12 : 1.e-12;
+          p.o[a][l] = o[a];
+          p.inv[a][l] = 1./d[a];
+          G4double t = ((d[a] > 0. ? fScene.hi[a] : fScene.lo[a]) - o[a])/d[a];
+          if(t < tExit[l]){ tExit[l] = t; exitAxis[l] = a; exitSign[l] = (d[a] > 0.) ? -1. : 1.; }
+        }
+        sInt[l] = (mu > 0. && rand[l] > 0.) ? -std::log(rand[l])/mu : DBL_MAX;
+        p.tBest[l] = std::min(sInt[l], tExit[l]);
+        p.hit[l] = -1;
+      }
+
+      Traverse(p);
+
+      G4int nScattered = 0;
+      for(G4int l=0; l<p.n; l++){
+        G4int i = p.index[l];
+        G4double t = p.tBest[l];
+        fX[i] += t*fDx[i];
+        fY[i] += t*fDy[i];
+        fZ[i] += t*fDz[i];
+        fNSteps++;
+
+        if(p.hit[l] >= 0){
+          const TracerBox& b = fScene.boxes[p.hit[l]];
+          if(b.code >= 0) hits.push_back(std::make_pair(b.code, fW[i]));
+          G4double sign;
+          G4int axis = HitFace(b, i, sign);
+          Reflect(i, axis, sign, b.reflectivity);
+        }else if(sInt[l] < tExit[l]){
+          if(G4UniformRand()*mu < muAbs){ Remove(i); continue; }
+          scattered[nScattered] = i;
+          sx[nScattered] = fDx[i]; sy[nScattered] = fDy[i]; sz[nScattered] = fDz[i];
+          spx[nScattered] = fPx[i]; spy[nScattered] = fPy[i]; spz[nScattered] = fPz[i];
+          nScattered++;
+        }else if(fScene.periodicZ && exitAxis[l] == 2){
+          fZ[i] = (fDz[i] > 0.) ? fScene.lo[2] + fEpsilon : fScene.hi[2] - fEpsilon;
+        }else{
+          Reflect(i, exitAxis[l], exitSign[l], fScene.wallReflectivity);
+        }
+      }
+
+      if(nScattered > 0){
+        CLHEP::HepRandom::getTheEngine()->flatArray(3*nScattered, rand);
+        fSampler.ScatterBatch(nScattered, sx, sy, sz, spx, spy, spz, rand);
+        for(G4int k=0; k<nScattered; k++){
+          G4int i = scattered[k];
+          fDx[i] = sx[k];  fDy[i] = sy[k];  fDz[i] = sz[k];
+          fPx[i] = spx[k]; fPy[i] = spy[k]; fPz[i] = spz[k];
+        }
+      }
+    }
+
+    size_t kept = 0;
+    for(size_t k=0; k<active.size(); k++)
+      if(fAlive[active[k]]) active[kept++] = active[k];
+    active.resize(kept);
+  }
+
+  Clear();
+}
+
+void BoxTracer::Clear()
+{
+  fX.clear();  fY.clear();  fZ.clear();
+  fDx.clear(); fDy.clear(); fDz.clear();
+  fPx.clear(); fPy.clear(); fPz.clear();
+  fW.clear();
+  fAlive.clear();
+}
@@ -5,68 +5,824 @@
 // Added modifications should be reported in arapuca.cc header comments                                                                                      
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
+#include "ArrayParameterisation.hh"
+#include "SteppingAction.hh"
+#include "NavigationStats.hh"
+#include "EMShowerModel.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Tubs.hh"
 #include "G4EllipticalTube.hh"
+#include "G4ExtrudedSolid.hh"
 #include "G4Orb.hh"
 #include "G4Sphere.hh"
 #include "G4NistManager.hh"
+#include "G4GeometryManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4RunManager.hh"
+#include "G4GenericMessenger.hh"
 
 #include "G4Color.hh"
 #include "G4VisAttributes.hh"
+#include "G4VisExtent.hh"
+#include "G4Version.hh"
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <map>
+#include <set>
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+// placements are not overlap-checked while building; run
+// g4workshop --validate-geometry (GeometryValidator) instead
+static const G4bool checkOverlaps = false;
+
+#ifdef G4LIB_USE_GDML
+static G4GDMLAuxStructType MakeAux(const G4String& type, const G4String& value)
+{
+  G4GDMLAuxStructType aux;
+  aux.type = type;
+  aux.value = value;
+  aux.unit = "";
+  aux.auxList = 0;
+  return aux;
+}
+#endif
+
+G4ThreadLocal EMShowerModel* DetectorConstruction::fShowerModel = 0;
 
 DetectorConstruction::DetectorConstruction()
   :fDefaultMaterial(NULL),
    fPhysiWorld(NULL),fLogicWorld(NULL),fSolidWorld(NULL),
-   fPhysiVol(NULL),fLogicVol(NULL),fSolidVol(NULL)
+   fPhysiVol(NULL),fLogicVol(NULL),fSolidVol(NULL),fMessenger(NULL)
 {
   fWorldSizeX=15.8; //in meters                                                                                                                              
   fWorldSizeY=10.0; //in meters                                                                                                                              
-  fWorldSizeZ=65.0;
 
   fCryostat_x = 14.8; //in meters                                                                                                                            
   fCryostat_y = 6.5; //in meters                                                                                                                             
-  fCryostat_z = 60.0; //in meters                                                                                                                             
   newfCryostat_x = 15.1; //in meters
                                            
   newfCryostat_y = 8.5; //in meters                    
-  
-  newfCryostat_z = 62.0; //in meters     
 
   fFC_x = 13.5; //in meters                                                                                                                                  
   fFC_y = fCryostat_y; //in meters                                                                                                                           
-  fFC_z = fCryostat_z; //in meters 
 
   fCathode_x = 13.5; //Cathode size in m                                                                                                                     
-  fCathode_z = 60.0; //Cathode size in m                                                         
   fLatY = 6.5; //APA internal size in cm                                                                                                                     
-  fLatZ = 60.0;
 
   fthickness=0.10; //m
   fAPA_thickness = 0.005; //m -- Temporarily using for FC
   fwindow = 0.6; //Arapuca window size in m
-    
-  fFC_z = fCryostat_z - fthickness;
+
+  fPeriod_z = 3.0; //Arapuca layout repeats every 3 m in z
+  fFullPeriods = 20;
+  fPeriods = 0;
+  fNBuilds = 0;
+  fParameterised = false;
+  fContainers = false;
+  fFieldCageShape = kFieldCageExact;
+  fSmartless = -1.;
+  fVoxelise = true;
+  fNavigationStats = false;
+  fLogicCryostat = 0;
+  fMaterialsDefined = false;
+  SetLengths();
+
+  // Arapuca layout
+  fLatRows = 4;
+  fLatColumns = 1;
+  fLatRowPitch = 0.8; //m
+  fCathodeGroups = 2; //8 cathode windows per 1.5 m
+  fCathodeWindows = 8;
+  const G4double cathode[16] = {-5.5, -1.5, 2.5, 6.5, -7.5, -3.5, 0.5, 4.5,
+                                -4.5, -0.5, 3.5, 7.5, -6.5, -2.5, 1.5, 5.5};
+  for(G4int k=0; k<16; k++) fCathodeOffsets.push_back(cathode[k]*0.84375); //m
+  fDistFromCryoWall = 0.1; //m
+
+  // production cuts; the active LAr keeps the Geant4 default
+  fRegionCuts["ActiveLAr"] = 1.*mm;
+  fRegionCuts["Arapuca"] = 1.*cm;
+  fRegionCuts["Outer"] = 10.*cm;
+  fOuterLimits = new G4UserLimits(DBL_MAX, DBL_MAX, DBL_MAX, 1.*MeV);
+
+  fLatWindow_x = fBotWindow_y = fShortWindow_z = 0.;
+  fChannelMapFile = "channel_map.csv";
+
+  fMessenger = new DetectorMessenger(this);
+  fLayoutMessenger = 0;
+  DefineLayoutCommands();
 }
 
-DetectorConstruction::DetectorConstruction(double size)
-  :fDefaultMaterial(NULL),
-   fPhysiWorld(NULL),fLogicWorld(NULL),fSolidWorld(NULL),
-   fPhysiVol(NULL),fLogicVol(NULL),fSolidVol(NULL)
-{//  fWorldSizeX=Y=fWorldSizeZ=0;
-  //  fsize = size;
+DetectorConstruction::DetectorConstruction(double)
+  :DetectorConstruction()
+{// the size is not used: same state as the default detector
 }
 
 DetectorConstruction::~DetectorConstruction()
-{delete fDefaultMaterial;}
+{delete fDefaultMaterial; delete fMessenger; delete fLayoutMessenger; delete fOuterLimits;}
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
-{DefineMaterials();return ConstructLine();}
+{
+  SetLengths();
+
+  // first construction in this process: a cached GDML of the same
+  // parameters replaces DefineMaterials() and ConstructLine()
+  if(!fPhysiWorld && UseGdmlCache() && ReadGdml(GetGdmlCacheFile())){
+    FindLoadedMaterials();
+    fNBuilds++;
+    ConstructRegions();
+    if(fChannelMapFile != "") WriteChannelMap(fChannelMapFile);
+    return fPhysiWorld;
+  }
+
+  if(fPhysiWorld){ // rebuilt after /testem/det/periods
+    G4GeometryManager::GetInstance()->OpenGeometry();
+    G4PhysicalVolumeStore::GetInstance()->Clean();
+    G4LogicalVolumeStore::GetInstance()->Clean();
+    G4SolidStore::GetInstance()->Clean();
+    G4LogicalSkinSurface::CleanSurfaceTable();
+    G4LogicalBorderSurface::CleanSurfaceTable();
+    for(size_t k=0; k<fArrays.size(); k++) delete fArrays[k];
+    fArrays.clear();
+  }
+  if(!fMaterialsDefined) DefineMaterials();
+  fNBuilds++;
+  ConstructLine();
+  ConstructRegions();
+  if(fChannelMapFile != "") WriteChannelMap(fChannelMapFile);
+
+  if(UseGdmlCache()){
+    G4String file = GetGdmlCacheFile();
+    if(!std::ifstream(file.c_str()).good()){
+      // written under another name and renamed, so that concurrent jobs
+      // never read a partial file
+      mkdir(fGdmlCacheDir.c_str(), 0755);
+      std::ostringstream tmp;
+      tmp << file << ".tmp" << getpid();
+      if(WriteGdml(tmp.str())) std::rename(tmp.str().c_str(), file.c_str());
+    }
+  }
+  return fPhysiWorld;
+}
+
+G4bool DetectorConstruction::UseGdmlCache() const
+{
+  // ArrayParameterisation (channels per copy) has no GDML representation
+  return !fGdmlCacheDir.empty() && !fParameterised;
+}
+
+G4String DetectorConstruction::GetGeometryKey() const
+{
+  // everything ConstructLine depends on; bump the revision whenever
+  // ConstructLine itself changes
+  const G4int revision = 4;
+  std::ostringstream par;
+  par.precision(17);
+  par << revision << ' ' << G4VERSION_NUMBER << ' ' << fPeriods << ' ' << fContainers << ' ' << fFieldCageShape << ' ' << fFullPeriods << ' '
+      << fPeriod_z << ' ' << fWorldSizeX << ' ' << fWorldSizeY << ' '
+      << fCryostat_x << ' ' << fCryostat_y << ' ' << newfCryostat_x << ' ' << newfCryostat_y << ' '
+      << fFC_x << ' ' << fFC_y << ' ' << fCathode_x << ' ' << fLatY << ' '
+      << fthickness << ' ' << fAPA_thickness << ' ' << fwindow << ' '
+      << fLatRows << ' ' << fLatColumns << ' ' << fLatRowPitch << ' '
+      << fCathodeGroups << ' ' << fCathodeWindows << ' ' << fDistFromCryoWall;
+  for(size_t k=0; k<fCathodeOffsets.size(); k++) par << ' ' << fCathodeOffsets[k];
+
+  // FNV-1a
+  const std::string text = par.str();
+  unsigned long long hash = 14695981039346656037ULL;
+  for(size_t i=0; i<text.size(); i++){
+    hash ^= (unsigned char)text[i];
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex;
+  key.width(16);
+  key.fill('0');
+  key << hash;
+  return key.str();
+}
+
+G4String DetectorConstruction::GetGdmlCacheFile() const
+{
+  return fGdmlCacheDir + "/fd2_" + GetGeometryKey() + ".gdml";
+}
+
+G4bool DetectorConstruction::WriteGdml(const G4String& fileName)
+{
+#ifdef G4LIB_USE_GDML
+  if(!fPhysiWorld) return false;
+  G4GDMLParser parser;
+
+  // what the rest of the simulation takes from ConstructLine, and the
+  // surface tables in case this Geant4 does not store them in GDML
+  std::vector<G4GDMLAuxStructType> aux;
+  std::ostringstream value;
+  value.precision(10);
+  value << GetGeometryKey();
+  aux.push_back(MakeAux("geometryKey", value.str()));
+  value.str(""); value << fLatWindow_x/mm << ' ' << fBotWindow_y/mm << ' ' << fShortWindow_z/mm;
+  aux.push_back(MakeAux("windowPositions", value.str()));
+  for(size_t k=0; k<fWindowPlanes.size(); k++){
+    const WindowPlane& plane = fWindowPlanes[k];
+    value.str("");
+    value << plane.axis << ' ' << plane.pos/mm << ' '
+          << plane.lo.x()/mm << ' ' << plane.lo.y()/mm << ' ' << plane.lo.z()/mm << ' '
+          << plane.hi.x()/mm << ' ' << plane.hi.y()/mm << ' ' << plane.hi.z()/mm;
+    aux.push_back(MakeAux("windowPlane", value.str()));
+  }
+  for(size_t k=0; k<fChannels.size(); k++){
+    const Channel& channel = fChannels[k];
+    value.str("");
+    value << channel.id << ' ' << channel.name << ' ' << channel.group << ' '
+          << channel.center.x()/mm << ' ' << channel.center.y()/mm << ' ' << channel.center.z()/mm << ' '
+          << channel.normal.x() << ' ' << channel.normal.y() << ' ' << channel.normal.z() << ' '
+          << channel.size.x()/mm << ' ' << channel.size.y()/mm << ' ' << channel.size.z()/mm;
+    aux.push_back(MakeAux("channel", value.str()));
+  }
+  std::set<G4String> written;
+  const G4LogicalSkinSurfaceTable* skins = G4LogicalSkinSurface::GetSurfaceTable();
+  for(size_t i=0; i<skins->size(); i++){
+    G4OpticalSurface* surf = dynamic_cast<G4OpticalSurface*>((*skins)[i]->GetSurfaceProperty());
+    if(!surf || !surf->GetMaterialPropertiesTable() || !written.insert(surf->GetName()).second) continue;
+    const char* props[2] = {"REFLECTIVITY", "EFFICIENCY"};
+    for(G4int k=0; k<2; k++){
+      G4MaterialPropertyVector* v = surf->GetMaterialPropertiesTable()->GetProperty(props[k]);
+      if(!v) continue;
+      value.str("");
+      value << surf->GetName() << ' ' << props[k] << ' ' << v->GetVectorLength();
+      for(size_t j=0; j<v->GetVectorLength(); j++) value << ' ' << v->Energy(j)/eV << ' ' << (*v)[j];
+      aux.push_back(MakeAux("surfaceProperty", value.str()));
+    }
+  }
+  for(size_t k=0; k<aux.size(); k++) parser.AddVolumeAuxiliary(aux[k], fLogicWorld);
+
+  std::remove(fileName.c_str());  // the GDML writer refuses to overwrite
+  parser.Write(fileName, fPhysiWorld);
+  G4cout << "DetectorConstruction: geometry " << GetGeometryKey() << " written to " << fileName << G4endl;
+  return true;
+#else
+  G4cout << "DetectorConstruction: Geant4 built without GDML, "
+         << fileName << " not written" << G4endl;
+  return false;
+#endif
+}
+
+G4bool DetectorConstruction::ReadGdml(const G4String& fileName)
+{
+#ifdef G4LIB_USE_GDML
+  if(!std::ifstream(fileName.c_str()).good()) return false;
+  G4GDMLParser parser;
+  parser.Read(fileName, false);  // written by WriteGdml, no schema validation
+  fPhysiWorld = parser.GetWorldVolume();
+  if(!fPhysiWorld) return false;
+  fLogicWorld = fPhysiWorld->GetLogicalVolume();
+  fSolidWorld = dynamic_cast<G4Box*>(fLogicWorld->GetSolid());
+  fDefaultMaterial = fLogicWorld->GetMaterial();
+  fLogicCryostat = 0;
+  for(G4int i=0; i<fLogicWorld->GetNoDaughters(); i++)
+    if(fLogicWorld->GetDaughter(i)->GetName() == "Cryostat")
+      fLogicCryostat = fLogicWorld->GetDaughter(i)->GetLogicalVolume();
+  if(fLogicCryostat){
+    if(fSmartless > 0.) fLogicCryostat->SetSmartless(fSmartless);
+    fLogicCryostat->SetOptimisation(fVoxelise);
+  }
+
+  fWindowPlanes.clear();
+  fChannels.clear();
+  std::map<G4String, std::map<G4String, std::vector<G4double> > > surfaceProperties;
+  G4GDMLAuxListType aux = parser.GetVolumeAuxiliaryInformation(fLogicWorld);
+  for(size_t k=0; k<aux.size(); k++){
+    std::istringstream value(aux[k].value);
+    if(aux[k].type == "windowPositions"){
+      value >> fLatWindow_x >> fBotWindow_y >> fShortWindow_z;
+      fLatWindow_x *= mm; fBotWindow_y *= mm; fShortWindow_z *= mm;
+    }
+    if(aux[k].type == "windowPlane"){
+      WindowPlane plane;
+      G4double lo[3], hi[3];
+      value >> plane.axis >> plane.pos >> lo[0] >> lo[1] >> lo[2] >> hi[0] >> hi[1] >> hi[2];
+      plane.pos *= mm;
+      plane.lo = G4ThreeVector(lo[0],lo[1],lo[2])*mm;
+      plane.hi = G4ThreeVector(hi[0],hi[1],hi[2])*mm;
+      fWindowPlanes.push_back(plane);
+    }
+    if(aux[k].type == "channel"){
+      Channel channel;
+      G4double c[3], n[3], d[3];
+      value >> channel.id >> channel.name >> channel.group >> c[0] >> c[1] >> c[2]
+            >> n[0] >> n[1] >> n[2] >> d[0] >> d[1] >> d[2];
+      channel.center = G4ThreeVector(c[0],c[1],c[2])*mm;
+      channel.normal = G4ThreeVector(n[0],n[1],n[2]);
+      channel.size = G4ThreeVector(d[0],d[1],d[2])*mm;
+      fChannels.push_back(channel);
+    }
+    if(aux[k].type == "surfaceProperty"){
+      G4String surface, property;
+      size_t n;
+      value >> surface >> property >> n;
+      std::vector<G4double>& table = surfaceProperties[surface][property];
+      table.resize(2*n);
+      for(size_t j=0; j<2*n; j++) value >> table[j];
+    }
+  }
+
+  // surface tables the GDML reader did not restore
+  const G4LogicalSkinSurfaceTable* skins = G4LogicalSkinSurface::GetSurfaceTable();
+  for(size_t i=0; i<skins->size(); i++){
+    G4OpticalSurface* surf = dynamic_cast<G4OpticalSurface*>((*skins)[i]->GetSurfaceProperty());
+    if(!surf || !surfaceProperties.count(surf->GetName())) continue;
+    G4MaterialPropertiesTable* mpt = surf->GetMaterialPropertiesTable();
+    if(!mpt){
+      mpt = new G4MaterialPropertiesTable();
+      surf->SetMaterialPropertiesTable(mpt);
+    }
+    std::map<G4String, std::vector<G4double> >& props = surfaceProperties[surf->GetName()];
+    for(std::map<G4String, std::vector<G4double> >::iterator it=props.begin(); it!=props.end(); ++it){
+      if(mpt->GetProperty(it->first)) continue;
+      size_t n = it->second.size()/2;
+      std::vector<G4double> energy(n), data(n);
+      for(size_t j=0; j<n; j++){ energy[j] = it->second[2*j]*eV; data[j] = it->second[2*j+1]; }
+      mpt->AddProperty(it->first, &energy[0], &data[0], n);
+    }
+  }
+  G4cout << "DetectorConstruction: geometry read from " << fileName << G4endl;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void DetectorConstruction::SetLengths()
+{
+  // full detector: 1 m of LAr between the end walls and the cryostat;
+  // periodic: the cryostat ends are the period boundaries
+  fCryostat_z = GetNumberOfPeriods()*fPeriod_z; //in meters
+  newfCryostat_z = IsPeriodic() ? fCryostat_z : fCryostat_z + 2.0; //in meters
+  fWorldSizeZ = newfCryostat_z + 3.0;
+  fCathode_z = fLatZ = fCryostat_z;
+  fFC_z = IsPeriodic() ? fCryostat_z - 0.001 : fCryostat_z - fthickness;
+  fPeriodOffset = IsPeriodic() ? (fFullPeriods - fPeriods)/2 : 0;
+}
+
+void DetectorConstruction::SetPeriods(G4int n)
+{
+  if(n > fFullPeriods) n = fFullPeriods;
+  if(n < 0) n = 0;
+  fPeriods = n;
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+G4double DetectorConstruction::GetPeriodShiftZ() const
+{
+  return (-fFullPeriods*fPeriod_z/2 + (fPeriodOffset + 0.5*GetNumberOfPeriods())*fPeriod_z)*m;
+}
+
+G4double DetectorConstruction::GetPeriodicHalfZ() const
+{
+  return fCryostat_z/2*m;
+}
+
+G4ThreeVector DetectorConstruction::GetActiveHalfSize() const
+{
+  return G4ThreeVector(newfCryostat_x/2*m, fCryostat_y/2*m, newfCryostat_z/2*m);
+}
+
+void DetectorConstruction::AddWindowToPlane(G4int axis, const G4ThreeVector& center, const G4ThreeVector& halfSize)
+{
+  for(size_t k=0; k<fWindowPlanes.size(); k++){
+    WindowPlane& plane = fWindowPlanes[k];
+    if(plane.axis != axis || std::fabs(plane.pos-center[axis]) > 1*mm) continue;
+    for(G4int a=0; a<3; a++){
+      plane.lo[a] = std::min(plane.lo[a], center[a]-halfSize[a]);
+      plane.hi[a] = std::max(plane.hi[a], center[a]+halfSize[a]);
+    }
+    return;
+  }
+  WindowPlane plane;
+  plane.axis = axis;
+  plane.pos = center[axis];
+  plane.lo = center-halfSize;
+  plane.hi = center+halfSize;
+  fWindowPlanes.push_back(plane);
+}
+
+void DetectorConstruction::AddChannel(const G4String& name, G4int group, const G4ThreeVector& center,
+                                      const G4ThreeVector& normal, const G4ThreeVector& halfSize)
+{
+  Channel channel;
+  channel.id = SteppingAction::VolumeCode(name).first;
+  channel.name = name;
+  channel.group = group;
+  channel.center = center;
+  channel.normal = normal;
+  channel.size = 2.*halfSize;
+  fChannels.push_back(channel);
+  G4int axis = (normal.x() != 0.) ? 0 : ((normal.y() != 0.) ? 1 : 2);
+  AddWindowToPlane(axis, center, halfSize);
+}
+
+const char* DetectorConstruction::GroupName(G4int group)
+{
+  switch(group){
+    case kLateral: return "lateral";
+    case kCathode: return "cathode";
+    case kShort:   return "short";
+    default:       return "unknown";
+  }
+}
+
+G4bool DetectorConstruction::WriteChannelMap(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out){
+    G4cerr << "DetectorConstruction: cannot write " << fileName << G4endl;
+    return false;
+  }
+  out << "id,name,group,x_mm,y_mm,z_mm,nx,ny,nz,dx_mm,dy_mm,dz_mm\n";
+  G4int count[3] = {0, 0, 0};
+  for(size_t k=0; k<fChannels.size(); k++){
+    const Channel& c = fChannels[k];
+    out << c.id << ',' << c.name << ',' << GroupName(c.group) << ','
+        << c.center.x()/mm << ',' << c.center.y()/mm << ',' << c.center.z()/mm << ','
+        << c.normal.x() << ',' << c.normal.y() << ',' << c.normal.z() << ','
+        << c.size.x()/mm << ',' << c.size.y()/mm << ',' << c.size.z()/mm << '\n';
+    if(c.group >= 0 && c.group < 3) count[c.group]++;
+  }
+  G4cout << "DetectorConstruction: channel map (" << count[kLateral] << " lateral, "
+         << count[kCathode] << " cathode, " << count[kShort] << " short) written to "
+         << fileName << G4endl;
+  return true;
+}
+
+void DetectorConstruction::ConstructRegions()
+{
+  // root volumes by name, so that a geometry read from GDML and rebuilt
+  // Arapucas get them too; the regions outlive full rebuilds, whose
+  // volumes leave the root lists when they are deleted
+  std::map<G4String,G4String> roots;
+  roots["Cryostat"] = "ActiveLAr";
+  roots["ArapucaWalls"] = roots["ArapucaWindow"] = "Arapuca";
+  roots["ArapucaBot"] = roots["ArapucaWindowBot"] = "Arapuca";
+  roots["ShortArapucaWalls"] = roots["ArapucaWindowShort"] = "Arapuca";
+  roots["Sheel"] = "Outer";
+
+  G4RegionStore* regions = G4RegionStore::GetInstance();
+  const G4LogicalVolumeStore* volumes = G4LogicalVolumeStore::GetInstance();
+  for(size_t i=0; i<volumes->size(); i++){
+    std::map<G4String,G4String>::const_iterator it = roots.find((*volumes)[i]->GetName());
+    if(it != roots.end()) regions->FindOrCreateRegion(it->second)->AddRootLogicalVolume((*volumes)[i]);
+  }
+  for(std::map<G4String,G4double>::const_iterator it = fRegionCuts.begin(); it != fRegionCuts.end(); ++it){
+    G4Region* region = regions->FindOrCreateRegion(it->first);
+    if(!region->GetProductionCuts()) region->SetProductionCuts(new G4ProductionCuts());
+    region->GetProductionCuts()->SetProductionCut(it->second);
+  }
+  regions->GetRegion("Outer")->SetUserLimits(fOuterLimits);
+  G4Region* world = regions->GetRegion("DefaultRegionForTheWorld", false);
+  if(world) world->SetUserLimits(fOuterLimits);
+}
+
+void DetectorConstruction::ConstructSDandField()
+{
+  // the region outlives full rebuilds, and so does the model attached to it
+  G4Region* region = G4RegionStore::GetInstance()->GetRegion("ActiveLAr", false);
+  if(!fShowerModel && region) fShowerModel = new EMShowerModel("EMShower", region);
+}
+
+void DetectorConstruction::SetRegionCut(const G4String& name, G4double cut)
+{
+  if(!fRegionCuts.count(name)){
+    G4cerr << "DetectorConstruction: no region " << name << ", cut not set" << G4endl;
+    return;
+  }
+  fRegionCuts[name] = cut;
+  // a built geometry takes it at the next run; the world follows Outer
+  // (see PhysicsList::SetCuts)
+  G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+  if(region && region->GetProductionCuts()) region->GetProductionCuts()->SetProductionCut(cut);
+  G4Region* world = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+  if(name == "Outer" && world && world->GetProductionCuts()) world->GetProductionCuts()->SetProductionCut(cut);
+}
+
+void DetectorConstruction::SetOuterMinEkin(G4double val)
+{
+  if(fOuterLimits) fOuterLimits->SetUserMinEkine(val);
+}
+
+void DetectorConstruction::SetParameterised(G4bool val)
+{
+  fParameterised = val;
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+void DetectorConstruction::SetSmartless(G4double val)
+{
+  fSmartless = val;
+  if(!fLogicCryostat) return;
+  fLogicCryostat->SetSmartless(val);
+  // new voxels at the next run
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+void DetectorConstruction::SetVoxelise(G4bool val)
+{
+  fVoxelise = val;
+  if(!fLogicCryostat) return;
+  fLogicCryostat->SetOptimisation(val);
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+void DetectorConstruction::PrintVoxelStats() const
+{
+  if(!fLogicCryostat) return;
+  NavigationStats::PrintVoxels(fLogicCryostat);
+  // and the containers / arrays below it
+  for(G4int i=0; i<fLogicCryostat->GetNoDaughters(); i++){
+    const G4LogicalVolume* lv = fLogicCryostat->GetDaughter(i)->GetLogicalVolume();
+    if(lv->GetNoDaughters() > 1) NavigationStats::PrintVoxels(lv);
+  }
+}
+
+void DetectorConstruction::SetContainers(G4bool val)
+{
+  fContainers = val;
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+void DetectorConstruction::DefineLayoutCommands()
+{
+  fLayoutMessenger = new G4GenericMessenger(this, "/testem/layout/", "Arapuca layout");
+
+  G4GenericMessenger::Command& latRows = fLayoutMessenger->DeclareProperty("latRows", fLatRows,
+    "Rows of Arapucas on each lateral wall");
+  latRows.SetParameterName("n", false);
+  latRows.SetRange("n>=1 && n<=9");
+  latRows.SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& latColumns = fLayoutMessenger->DeclareProperty("latColumns", fLatColumns,
+    "Columns of lateral Arapucas per 3 m period (20 periods in the full detector)");
+  latColumns.SetParameterName("n", false);
+  latColumns.SetRange("n>=1 && n<=4");
+  latColumns.SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& latRowPitch = fLayoutMessenger->DeclareProperty("latRowPitch", fLatRowPitch,
+    "Vertical pitch of the lateral Arapuca rows, in m");
+  latRowPitch.SetParameterName("pitch", false);
+  latRowPitch.SetRange("pitch>0.");
+  latRowPitch.SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& cathodeGroups = fLayoutMessenger->DeclareProperty("cathodeGroups", fCathodeGroups,
+    "Groups of cathode Arapucas per 3 m period, each two rows in z");
+  cathodeGroups.SetParameterName("n", false);
+  cathodeGroups.SetRange("n>=1 && n<=4");
+  cathodeGroups.SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& cathodeWindows = fLayoutMessenger->DeclareProperty("cathodeWindows", fCathodeWindows,
+    "Cathode Arapucas per group, half in each row");
+  cathodeWindows.SetParameterName("n", false);
+  cathodeWindows.SetRange("n>=2 && n<=8");
+  cathodeWindows.SetStates(G4State_PreInit, G4State_Idle);
+
+  fLayoutMessenger->DeclareMethod("cathodeOffsets", &DetectorConstruction::SetCathodeOffsets,
+    "x of the cathode Arapucas in m, used in turn in placement order")
+    .SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& window = fLayoutMessenger->DeclareProperty("window", fwindow,
+    "Arapuca window size in m (frames are 5 cm larger)");
+  window.SetParameterName("size", false);
+  window.SetRange("size>0. && size<=0.75");
+  window.SetStates(G4State_PreInit, G4State_Idle);
+
+  G4GenericMessenger::Command& dist = fLayoutMessenger->DeclareProperty("distFromCryoWall", fDistFromCryoWall,
+    "Distance of the lateral and short-wall Arapucas from the cryostat wall, in m");
+  dist.SetParameterName("d", false);
+  dist.SetRange("d>=0.");
+  dist.SetStates(G4State_PreInit, G4State_Idle);
+
+  fLayoutMessenger->DeclareMethod("rebuild", &DetectorConstruction::RebuildArapucas,
+    "Replace the Arapucas of the built geometry with the current layout")
+    .SetStates(G4State_Idle);
+}
+
+void DetectorConstruction::SetCathodeOffsets(G4String list)
+{
+  std::istringstream in(list);
+  std::vector<G4double> offsets;
+  G4double x;
+  while(in >> x) offsets.push_back(x);
+  if(offsets.empty()){
+    G4cerr << "DetectorConstruction: no cathode offsets in \"" << list << "\", unchanged" << G4endl;
+    return;
+  }
+  fCathodeOffsets = offsets;
+}
+
+void DetectorConstruction::RebuildArapucas()
+{
+  if(!fPhysiWorld) return;
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  // the Arapucas of a geometry read from GDML are not known one by one
+  if(!fMaterialsDefined || !fLogicCryostat || fArapucaPlacements.empty()){
+    if(runManager) runManager->ReinitializeGeometry();
+    return;
+  }
+
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  // the replaced volumes stay in the stores (and keep their skins) until
+  // the next full construction
+  for(size_t k=0; k<fArapucaPlacements.size(); k++){
+    fLogicCryostat->RemoveDaughter(fArapucaPlacements[k]);
+    delete fArapucaPlacements[k];
+  }
+  fArapucaPlacements.clear();
+
+  G4VPhysicalVolume* physCryostat = 0;
+  for(G4int i=0; i<fLogicWorld->GetNoDaughters(); i++)
+    if(fLogicWorld->GetDaughter(i)->GetLogicalVolume() == fLogicCryostat) physCryostat = fLogicWorld->GetDaughter(i);
+  G4LogicalSkinSurface* skin = G4LogicalSkinSurface::GetSurface(fLogicCryostat);
+  G4OpticalSurface* surface = skin ? dynamic_cast<G4OpticalSurface*>(skin->GetSurfaceProperty()) : 0;
+
+  ConstructArapucas(physCryostat, surface);
+  ConstructRegions();
+  fNBuilds++;
+  G4cout << "DetectorConstruction: Arapucas rebuilt, " << fChannels.size() << " channels on "
+         << fWindowPlanes.size() << " window planes, "
+         << fLogicCryostat->GetNoDaughters() << " cryostat daughters" << G4endl;
+  if(fChannelMapFile != "") WriteChannelMap(fChannelMapFile);
+  if(runManager) runManager->GeometryHasBeenModified();
+}
+
+void DetectorConstruction::SetFieldCageShape(G4int shape)
+{
+  fFieldCageShape = shape;
+  if(G4RunManager::GetRunManager()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+G4VSolid* DetectorConstruction::FieldCageSolid(const G4String& name, G4double dy, G4double halfLength,
+                                               G4double cutShift) const
+{
+  // the profile is the part of an elliptical tube (half axes 5 mm x dy,
+  // along z) left of x = cutShift - 5 mm; the rounded side faces -x
+  const G4double dx = 5.*mm;
+  const G4double cosMax = (dx - cutShift)/dx;
+  const G4double thetaMax = std::acos(cosMax);
+  const G4double yMax = dy*std::sin(thetaMax);
+
+  if(fFieldCageShape == kFieldCagePolygon){
+    // vertices on the elliptical arc, clockwise, closed by the flat side
+    const G4int nSegments = 16;
+    std::vector<G4TwoVector> polygon;
+    for(G4int i=0; i<=nSegments; i++){
+      G4double theta = -thetaMax + 2.*thetaMax*i/nSegments;
+      polygon.push_back(G4TwoVector(-dx*std::cos(theta), dy*std::sin(theta)));
+    }
+    return new G4ExtrudedSolid(name, polygon, halfLength, G4TwoVector(), 1., G4TwoVector(), 1.);
+  }
+
+  if(fFieldCageShape == kFieldCageSlab){
+    // same height and front position as the profile; the thickness is
+    // such that front and edges add up to the length of the arc
+    const G4int nSteps = 200;
+    G4double arc = 0.;
+    for(G4int i=0; i<nSteps; i++){
+      G4double theta = -thetaMax + 2.*thetaMax*(i+0.5)/nSteps;
+      arc += std::sqrt(dx*dx*std::sin(theta)*std::sin(theta) + dy*dy*std::cos(theta)*std::cos(theta));
+    }
+    arc *= 2.*thetaMax/nSteps;
+    G4double thickness = std::max(0.5*(arc - 2.*yMax), 0.1*mm);
+    // a box offset to the front, as an extruded rectangle so that the
+    // GDML writer handles it (it has no displaced solids)
+    std::vector<G4TwoVector> rectangle;
+    rectangle.push_back(G4TwoVector(-dx, -yMax));
+    rectangle.push_back(G4TwoVector(-dx, yMax));
+    rectangle.push_back(G4TwoVector(-dx + thickness, yMax));
+    rectangle.push_back(G4TwoVector(-dx + thickness, -yMax));
+    return new G4ExtrudedSolid(name, rectangle, halfLength, G4TwoVector(), 1., G4TwoVector(), 1.);
+  }
+
+  G4EllipticalTube* aux = new G4EllipticalTube(name+"Aux", dx, dy, halfLength);
+  G4Box* out = new G4Box(name+"Out", dx, dy, halfLength + 1.*m);
+  return new G4SubtractionSolid(name, aux, out, 0, G4ThreeVector(cutShift, 0., 0.));
+}
+
+G4LogicalVolume* DetectorConstruction::GroupDaughters(G4LogicalVolume* mother, const G4String& name,
+                                                      const std::vector<G4LogicalVolume*>& members,
+                                                      G4int axis, G4int side)
+{
+  // daughters of the listed volumes on one side of the mother (side 0:
+  // all), as placed
+  std::vector<G4VPhysicalVolume*> moved;
+  G4ThreeVector lo(DBL_MAX,DBL_MAX,DBL_MAX), hi(-DBL_MAX,-DBL_MAX,-DBL_MAX);
+  for(G4int i=0; i<mother->GetNoDaughters(); i++){
+    G4VPhysicalVolume* pv = mother->GetDaughter(i);
+    if(std::find(members.begin(), members.end(), pv->GetLogicalVolume()) == members.end()) continue;
+    if(side*pv->GetTranslation()[axis] < 0.) continue;
+    moved.push_back(pv);
+
+    G4VisExtent extent = pv->GetLogicalVolume()->GetSolid()->GetExtent();
+    G4AffineTransform t(pv->GetRotation(), pv->GetTranslation());
+    for(G4int c=0; c<8; c++){
+      G4ThreeVector corner((c & 1) ? extent.GetXmax() : extent.GetXmin(),
+                           (c & 2) ? extent.GetYmax() : extent.GetYmin(),
+                           (c & 4) ? extent.GetZmax() : extent.GetZmin());
+      corner = t.TransformPoint(corner);
+      for(G4int a=0; a<3; a++){
+        lo[a] = std::min(lo[a], corner[a]);
+        hi[a] = std::max(hi[a], corner[a]);
+      }
+    }
+  }
+  if(moved.empty()) return 0;
+
+  // an LAr box just enclosing them takes their place
+  G4ThreeVector center = 0.5*(lo+hi);
+  G4Box* solid = new G4Box(name,(hi.x()-lo.x())/2,(hi.y()-lo.y())/2,(hi.z()-lo.z())/2);
+  G4LogicalVolume* logic = new G4LogicalVolume(solid,fDefaultMaterial,name);
+  for(size_t k=0; k<moved.size(); k++){
+    mother->RemoveDaughter(moved[k]);
+    moved[k]->SetTranslation(moved[k]->GetTranslation()-center);
+    moved[k]->SetMotherLogical(logic);
+    logic->AddDaughter(moved[k]);
+  }
+  new G4PVPlacement(0,center,logic,name,mother,false,0,checkOverlaps);
+  return logic;
+}
+
+void DetectorConstruction::PlaceCopy(G4LogicalVolume* lv, G4RotationMatrix* rot, const G4ThreeVector& pos,
+                                     G4int copyNo, ArrayParameterisation* param, G4VPhysicalVolume* mother)
+{
+  if(fParameterised) param->AddCopy(pos, rot);
+  else new G4PVPlacement(rot, pos, lv->GetName(), lv, mother, false, copyNo, checkOverlaps);
+}
+
+G4VPhysicalVolume* DetectorConstruction::PlaceArray(const G4String& name, G4LogicalVolume* lv,
+                                                    ArrayParameterisation* param, G4VPhysicalVolume* mother)
+{
+  // a parameterised volume has to be the only daughter of its mother, so
+  // the copies go into an LAr box just enclosing them
+  G4VisExtent extent = lv->GetSolid()->GetExtent();
+  G4ThreeVector lo(DBL_MAX,DBL_MAX,DBL_MAX), hi(-DBL_MAX,-DBL_MAX,-DBL_MAX);
+  for(G4int k=0; k<param->GetNoCopies(); k++){
+    for(G4int c=0; c<8; c++){
+      G4ThreeVector corner((c & 1) ? extent.GetXmax() : extent.GetXmin(),
+                           (c & 2) ? extent.GetYmax() : extent.GetYmin(),
+                           (c & 4) ? extent.GetZmax() : extent.GetZmin());
+      if(param->GetRotation(k)) corner = param->GetRotation(k)->inverse()*corner;
+      corner += param->GetPosition(k);
+      for(G4int a=0; a<3; a++){
+        lo[a] = std::min(lo[a], corner[a]);
+        hi[a] = std::max(hi[a], corner[a]);
+      }
+    }
+  }
+  G4ThreeVector center = 0.5*(lo+hi);
+  param->Shift(-center);
+  fArrays.push_back(param);
+
+  G4Box* solid = new G4Box(name,(hi.x()-lo.x())/2,(hi.y()-lo.y())/2,(hi.z()-lo.z())/2);
+  G4LogicalVolume* logic = new G4LogicalVolume(solid,fDefaultMaterial,name);
+  new G4PVPlacement(0,center,name,logic,mother,false,0,checkOverlaps);
+  return new G4PVParameterised(lv->GetName(),lv,logic,kUndefined,param->GetNoCopies(),param,false);
+}
+
+void DetectorConstruction::FindLoadedMaterials()
+{
+  // the materials read with a GDML geometry, so that a later rebuild (e.g.
+  // /testem/det/periods) uses them instead of defining them a second time;
+  // Teflon and G10 are in no volume, hence not in the file
+  fBase = fG10 = facrylic = fSteel = fAluminium = 0;
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  for(size_t i=0; i<materials->size(); i++){
+    G4Material* material = (*materials)[i];
+    const G4String& name = material->GetName();
+    if(name == "G4_lAr") fDefaultMaterial = material;
+    else if(name == "G4_TEFLON") fBase = material;
+    else if(name == "acrylic") facrylic = material;
+    else if(name == "StainlessSteel") fSteel = material;
+    else if(name == "Aluminium") fAluminium = material;
+    else if(name == "G10") fG10 = material;
+  }
+  fMaterialsDefined = fDefaultMaterial && facrylic && fSteel && fAluminium;
+}
 
 void DetectorConstruction::DefineMaterials()
 {
+  fMaterialsDefined = true;
   G4String name, symbol;
   G4double density;
 
@@ -184,19 +940,31 @@ fSolidWorld = new G4Box("World",fWorldSizeX/2*m,fWorldSizeY/2*m,fWorldSizeZ/2*m)
 fLogicWorld = new G4LogicalVolume(fSolidWorld,fDefaultMaterial,"World");
 //its solid; its material; its name
 fPhysiWorld = new G4PVPlacement(0,G4ThreeVector(),"World",fLogicWorld,NULL,false,0);
+fWindowPlanes.clear();
 //no rotation; (0,0,0); its name; its logical volume; its mother volume; no boolean operation; copy number
 
 G4Box* fSolidCryostat = new G4Box("Cryostat",(newfCryostat_x/2)*m, (newfCryostat_y/2.0+0.1)*m,(newfCryostat_z/2)*m); //make it a little bigger to avoid overlaps
-G4LogicalVolume* fLogicCryostat = new G4LogicalVolume(fSolidCryostat,fDefaultMaterial,"Cryostat");
+fLogicCryostat = new G4LogicalVolume(fSolidCryostat,fDefaultMaterial,"Cryostat");
+if(fSmartless > 0.) fLogicCryostat->SetSmartless(fSmartless);
+fLogicCryostat->SetOptimisation(fVoxelise);
 G4VPhysicalVolume* fPhysCryostat = new G4PVPlacement(0,G4ThreeVector(0,0,0),"Cryostat",
   fLogicCryostat,     //its logical volume
   fPhysiWorld,    //its mother  volume
   false,//no boolean operation
   0,
-  true); //check for overlaps
-
-G4Box* ShellOut = new G4Box("ShellOut",(newfCryostat_x/2+0.3)*m, (newfCryostat_y/2.0+0.3)*m,(newfCryostat_z/2+0.3)*m);
-G4SubtractionSolid* fShell = new G4SubtractionSolid("Shell", ShellOut, fSolidCryostat);
+  checkOverlaps); //check for overlaps
+
+G4VSolid* ShellIn = fSolidCryostat;
+G4double ShellEnd_z = 0.3; //m
+if(IsPeriodic()){ //no end plates, photons leaving in z re-enter at the other end
+  ShellIn = new G4Box("ShellIn",(newfCryostat_x/2)*m, (newfCryostat_y/2.0+0.1)*m,(newfCryostat_z/2+1.)*m);
+  ShellEnd_z = 0.;
+  G4cout << "Periodic geometry: " << fPeriods << " periods of " << fPeriod_z
+         << " m, z here is z" << (GetPeriodShiftZ() < 0 ? "" : "+") << GetPeriodShiftZ()/m
+         << " m in the full detector" << G4endl;
+}
+G4Box* ShellOut = new G4Box("ShellOut",(newfCryostat_x/2+0.3)*m, (newfCryostat_y/2.0+0.3)*m,(newfCryostat_z/2+ShellEnd_z)*m);
+G4SubtractionSolid* fShell = new G4SubtractionSolid("Shell", ShellOut, ShellIn);
 G4LogicalVolume* fLogicShell = new G4LogicalVolume(fShell,fSteel,"Sheel");
 G4VPhysicalVolume* fPhysShell = new G4PVPlacement(0,G4ThreeVector(0,0,0),"Sheel",
   fLogicShell,     //its logical volume
@@ -211,64 +979,66 @@ G4VPhysicalVolume* fPhysiCathode = new G4PVPlacement(0,G4ThreeVector(0,(-fCryost
   fPhysCryostat,    //its mother  volume
   false,//no boolean operation
   0,
-  true); //check for overlaps
+  checkOverlaps); //check for overlaps
 G4LogicalVolume* fLogicAnode = new G4LogicalVolume(fSolidCathode,fSteel,"Anode");
 G4VPhysicalVolume* fPhysiAnode = new G4PVPlacement(0,G4ThreeVector(0,(fCryostat_y/2.0+fthickness/2)*m,0),"Anode",
   fLogicAnode,     //its logical volume
   fPhysCryostat,    //its mother  volume
   false,//no boolean operation
   0,
-  true); //check for overlaps
+  checkOverlaps); //check for overlaps
 
 //FC Structure
 
 //Longer lateral
 G4double ypos=-fCryostat_y/2.0 + 0.04; //in m
-G4EllipticalTube* FCAuxwide = new G4EllipticalTube("FCAuxwide",5.*mm, 23.*mm,fFC_z/2*m);
-G4Box* FCAuxOut = new G4Box("FCAuxOut",5.*mm,23*mm,(fFC_z/2+1)*m);
-G4SubtractionSolid* fSolidFCwide = new G4SubtractionSolid("FieldCageWide", FCAuxwide, FCAuxOut, 0, G4ThreeVector((2.+5/2)*mm,0.,0.));
+G4VSolid* fSolidFCwide = FieldCageSolid("FieldCageWide", 23.*mm, fFC_z/2*m, (2.+5/2)*mm);
 G4LogicalVolume* fLogicFCwide = new G4LogicalVolume(fSolidFCwide,fAluminium,"FieldCageWide");
-G4VPhysicalVolume* fPhysFCwide = new G4PVPlacement(0,G4ThreeVector(fFC_x/2.*m,ypos*m,0),"FieldCageWide",
-  fLogicFCwide,     //its logical volume
-  fPhysCryostat,    //its mother  volume
-  false,//no boolean operation
-  0, true);
-
 G4RotationMatrix* r = new G4RotationMatrix();
 G4ThreeVector* axis = new G4ThreeVector(0.0,0.0,1.0);
 r->rotate(CLHEP::pi,axis);
 
-G4PVPlacement* ph_cp2  = new G4PVPlacement(r,G4ThreeVector(-fFC_x/2.*m,ypos*m,0), "FieldCageWide", fLogicFCwide, fPhysCryostat, false, 1, true);
+//parameterised mode: copies on each side collected here and placed at the end
+ArrayParameterisation* FCwideP = new ArrayParameterisation();
+ArrayParameterisation* FCwideM = new ArrayParameterisation();
+PlaceCopy(fLogicFCwide, 0, G4ThreeVector(fFC_x/2.*m,ypos*m,0), 0, FCwideP, fPhysCryostat);
+PlaceCopy(fLogicFCwide, r, G4ThreeVector(-fFC_x/2.*m,ypos*m,0), 1, FCwideM, fPhysCryostat);
 
 for(int i = 2; i<=50; i++){ //49 copies of FCwide (~ 2m)
 ypos+=0.06;
-G4PVPlacement* ph_cp  = new G4PVPlacement(0,G4ThreeVector(fFC_x/2.*m,ypos*m,0),
-  "FieldCageWide", fLogicFCwide, fPhysCryostat, false, i, true);
-ph_cp2  = new G4PVPlacement(r,G4ThreeVector(-fFC_x/2.*m,ypos*m,0),
-  "FieldCageWide", fLogicFCwide, fPhysCryostat, false, i+107, true);
+PlaceCopy(fLogicFCwide, 0, G4ThreeVector(fFC_x/2.*m,ypos*m,0), i, FCwideP, fPhysCryostat);
+PlaceCopy(fLogicFCwide, r, G4ThreeVector(-fFC_x/2.*m,ypos*m,0), i+107, FCwideM, fPhysCryostat);
 }
 
 ypos+=0.06;
-G4EllipticalTube* FCAuxSlim = new G4EllipticalTube("FCAuxSlim",5.*mm, 7.5*mm,fFC_z/2*m);
-G4Box* FCAuxSlimOut = new G4Box("FCAuxSlimOut",5.*mm,7.5*mm,(fFC_z/2+1)*m);
-G4SubtractionSolid* fSolidFCSlim = new G4SubtractionSolid("FieldCageSlim", FCAuxSlim, FCAuxSlimOut, 0, G4ThreeVector((2.+5/2)*mm,0.,0.));
+G4VSolid* fSolidFCSlim = FieldCageSolid("FieldCageSlim", 7.5*mm, fFC_z/2*m, (2.+5/2)*mm);
 G4LogicalVolume* fLogicFCSlim = new G4LogicalVolume(fSolidFCSlim,fAluminium,"FieldCageSlim");
-G4VPhysicalVolume* fPhysFCSlim = new G4PVPlacement(0,G4ThreeVector(fFC_x/2.*m,ypos*m,0),"FieldCageSlim",
-  fLogicFCSlim,     //its logical volume
-  fPhysCryostat,    //its mother  volume
-  false,//no boolean operation
-  0, true);
-ph_cp2  = new G4PVPlacement(r,G4ThreeVector(-fFC_x/2.*m,ypos*m,0), "FieldCageSlim", fLogicFCSlim, fPhysCryostat, false, 51, true);
+ArrayParameterisation* FCSlimP = new ArrayParameterisation();
+ArrayParameterisation* FCSlimM = new ArrayParameterisation();
+PlaceCopy(fLogicFCSlim, 0, G4ThreeVector(fFC_x/2.*m,ypos*m,0), 0, FCSlimP, fPhysCryostat);
+PlaceCopy(fLogicFCSlim, r, G4ThreeVector(-fFC_x/2.*m,ypos*m,0), 51, FCSlimM, fPhysCryostat);
 
 for(int i = 52; i<=107; i++){ //63 copies of FCSlim
 ypos+=0.06;
-G4PVPlacement* ph_cp  = new G4PVPlacement(0,G4ThreeVector(fFC_x/2.*m,ypos*m,0),
-  "FieldCageSlim", fLogicFCSlim, fPhysCryostat, false, i, true);
-ph_cp2  = new G4PVPlacement(r,G4ThreeVector(-fFC_x/2.*m,ypos*m,0),
-  "FieldCageSlim", fLogicFCSlim, fPhysCryostat, false, i+107, true);
+PlaceCopy(fLogicFCSlim, 0, G4ThreeVector(fFC_x/2.*m,ypos*m,0), i, FCSlimP, fPhysCryostat);
+PlaceCopy(fLogicFCSlim, r, G4ThreeVector(-fFC_x/2.*m,ypos*m,0), i+107, FCSlimM, fPhysCryostat);
 }
 
-//Shorter laterals
+if(fParameterised){
+  PlaceArray("FieldCageWideArrayP", fLogicFCwide, FCwideP, fPhysCryostat);
+  PlaceArray("FieldCageWideArrayM", fLogicFCwide, FCwideM, fPhysCryostat);
+  PlaceArray("FieldCageSlimArrayP", fLogicFCSlim, FCSlimP, fPhysCryostat);
+  PlaceArray("FieldCageSlimArrayM", fLogicFCSlim, FCSlimM, fPhysCryostat);
+}else{
+  delete FCwideP; delete FCwideM; delete FCSlimP; delete FCSlimM;
+}
+
+//Shorter laterals (none in the periodic geometry)
+G4LogicalVolume* fLogicFCShort = 0;
+G4LogicalVolume* fLogicFCShortSlim = 0;
+G4LogicalVolume* fLogicFCShortaux = 0;
+G4LogicalVolume* fLogicFCShortaux2 = 0;
+if(!IsPeriodic()){
 ypos=-fCryostat_y/2.0 + 0.04; //in m
 G4RotationMatrix* rSh = new G4RotationMatrix();
 G4ThreeVector* axisSh = new G4ThreeVector(0.0,1.0,0.0);
@@ -276,91 +1046,207 @@ rSh->rotate(CLHEP::pi/2,axisSh);
 G4RotationMatrix* rSh2 = new G4RotationMatrix();
 rSh2->rotate(-1.*CLHEP::pi/2,axisSh);
 
-G4EllipticalTube* FCAuxShort = new G4EllipticalTube("FCAuxShort",5.*mm, 23.*mm,(fFC_x/2.-0.005)*m);
-G4Box* FCAuxShOut = new G4Box("FCAuxShOut",5.*mm,23.*mm,(fFC_x/2.+1.)*m);
-G4SubtractionSolid* fSolidFCShort = new G4SubtractionSolid("FieldCageShort", FCAuxShort, FCAuxShOut, 0, G4ThreeVector((2.+5./2.)*mm,0.,0.));
-G4LogicalVolume* fLogicFCShort = new G4LogicalVolume(fSolidFCShort,fAluminium,"FieldCageShort");
+G4VSolid* fSolidFCShort = FieldCageSolid("FieldCageShort", 23.*mm, (fFC_x/2.-0.005)*m, (2.+5./2.)*mm);
+fLogicFCShort = new G4LogicalVolume(fSolidFCShort,fAluminium,"FieldCageShort");
 G4VPhysicalVolume* fPhysFCShort = new G4PVPlacement(rSh,G4ThreeVector(0,ypos*m,fFC_z/2.*m),"FieldCageShort",
 						    fLogicFCShort,     //its logical volume
 						    fPhysCryostat,    //its mother  volume
 						    false,//no boolean operation
-						    0, true);
+						    0, checkOverlaps);
 
-G4PVPlacement* sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2*m),"FieldCageShort", fLogicFCShort, fPhysCryostat, false, 1, true);
+G4PVPlacement* sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2*m),"FieldCageShort", fLogicFCShort, fPhysCryostat, false, 1, checkOverlaps);
     
 for(int i = 2; i<=50; i++){ //49 copies of FCShort
   ypos+=0.06;
   G4PVPlacement* sh_cp  = new G4PVPlacement(rSh,G4ThreeVector(0,ypos*m,fFC_z/2*m),
-					    "FieldCageShort", fLogicFCShort, fPhysCryostat, false, i, true);
+					    "FieldCageShort", fLogicFCShort, fPhysCryostat, false, i, checkOverlaps);
   sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2*m),
-			      "FieldCageShort", fLogicFCShort, fPhysCryostat, false, i+107, true);
+			      "FieldCageShort", fLogicFCShort, fPhysCryostat, false, i+107, checkOverlaps);
  }
 
 ypos+=0.06;
-G4EllipticalTube* FCAuxShortSlim = new G4EllipticalTube("FCAuxShortSlim",5.*mm, 7.5*mm,(fFC_x/2.-3.4)*m);
-G4Box* FCAuxShortSlimOut = new G4Box("FCAuxShortSlimOut",5.*mm,7.5*mm,(fFC_x/2.-3.4 + (fFC_x/2.-3.4)*2./fFC_x)*m);
-G4SubtractionSolid* fSolidFCShortSlim = new G4SubtractionSolid("FieldCageShortSlim", FCAuxShortSlim, FCAuxShortSlimOut, 0, G4ThreeVector((2.+5/2)*mm,0.,0.));
-G4LogicalVolume* fLogicFCShortSlim = new G4LogicalVolume(fSolidFCShortSlim,fAluminium,"FieldCageShortSlim");
+G4VSolid* fSolidFCShortSlim = FieldCageSolid("FieldCageShortSlim", 7.5*mm, (fFC_x/2.-3.4)*m, (2.+5/2)*mm);
+fLogicFCShortSlim = new G4LogicalVolume(fSolidFCShortSlim,fAluminium,"FieldCageShortSlim");
 G4VPhysicalVolume* fPhysFCShortSlim = new G4PVPlacement(rSh,G4ThreeVector(0,ypos*m,fFC_z/2.*m),"FieldCageShortSlim",
 							fLogicFCShortSlim,     //its logical volume
 							fPhysCryostat,    //its mother  volume
 							false,//no boolean operation
-							0, true);
-sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2*m), "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, 51, true);
+							0, checkOverlaps);
+sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2*m), "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, 51, checkOverlaps);
   
-G4EllipticalTube* FCAuxShortaux = new G4EllipticalTube("FCAuxShortaux",5.*mm, 23.*mm,(3.4/2-0.005)*m);
-G4Box* FCAuxShOutaux = new G4Box("FCAuxShOutaux",5.*mm,23.*mm,(3.4/2 + 3.4/fFC_x)*m);
-G4SubtractionSolid* fSolidFCShortaux = new G4SubtractionSolid("FieldCageShortaux", FCAuxShortaux, FCAuxShOutaux, 0, G4ThreeVector((2.+5./2.)*mm,0.,0.));
-G4LogicalVolume* fLogicFCShortaux = new G4LogicalVolume(fSolidFCShortaux,fAluminium,"FieldCageShortaux");
+G4VSolid* fSolidFCShortaux = FieldCageSolid("FieldCageShortaux", 23.*mm, (3.4/2-0.005)*m, (2.+5./2.)*mm);
+fLogicFCShortaux = new G4LogicalVolume(fSolidFCShortaux,fAluminium,"FieldCageShortaux");
 G4VPhysicalVolume* fPhysFCShortaux = new G4PVPlacement(rSh,G4ThreeVector(((fFC_x/2.-3.4)+3.4/2)*m,ypos*m,fFC_z/2.*m),"FieldCageShortaux",
 						       fLogicFCShortaux,     //its logical volume
 						       fPhysCryostat,    //its mother  volume
 						       false,//no boolean operation
-						       0, true);
+						       0, checkOverlaps);
     
-G4PVPlacement* sh_cp4  = new G4PVPlacement(rSh2,G4ThreeVector(((fFC_x/2.-3.4)+3.4/2)*m,ypos*m,-fFC_z/2*m),"FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, 215, true);
+G4PVPlacement* sh_cp4  = new G4PVPlacement(rSh2,G4ThreeVector(((fFC_x/2.-3.4)+3.4/2)*m,ypos*m,-fFC_z/2*m),"FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, 215, checkOverlaps);
     
-G4EllipticalTube* FCAuxShortaux2 = new G4EllipticalTube("FCAuxShortaux2",5.*mm, 23.*mm,(3.4/2-0.005)*m);
-G4Box* FCAuxShOutaux2 = new G4Box("FCAuxShOutaux2",5.*mm,23.*mm,(3.4/2 + 3.4/fFC_x)*m);
-G4SubtractionSolid* fSolidFCShortaux2 = new G4SubtractionSolid("FieldCageShortaux2", FCAuxShortaux2, FCAuxShOutaux2, 0, G4ThreeVector((2.+5./2.)*mm,0.,0.));
-G4LogicalVolume* fLogicFCShortaux2 = new G4LogicalVolume(fSolidFCShortaux2,fAluminium,"FieldCageShortaux2");
+G4VSolid* fSolidFCShortaux2 = FieldCageSolid("FieldCageShortaux2", 23.*mm, (3.4/2-0.005)*m, (2.+5./2.)*mm);
+fLogicFCShortaux2 = new G4LogicalVolume(fSolidFCShortaux2,fAluminium,"FieldCageShortaux2");
 G4VPhysicalVolume* fPhysFCShortaux2 = new G4PVPlacement(rSh,G4ThreeVector(((-fFC_x/2.+3.4)-3.4/2)*m,ypos*m,fFC_z/2.*m),"FieldCageShortaux2",
 							fLogicFCShortaux2,     //its logical volume
 							fPhysCryostat,    //its mother  volume
 							false,//no boolean operation
-							0, true);
+							0, checkOverlaps);
       
-G4PVPlacement* sh_cp6  = new G4PVPlacement(rSh2,G4ThreeVector(((-fFC_x/2.+3.4)-3.4/2)*m,ypos*m,-fFC_z/2*m),"FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, 328, true);
+G4PVPlacement* sh_cp6  = new G4PVPlacement(rSh2,G4ThreeVector(((-fFC_x/2.+3.4)-3.4/2)*m,ypos*m,-fFC_z/2*m),"FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, 328, checkOverlaps);
   
 for(int i = 52; i<=107; i++){ //56 copies of FCShortSlim
   ypos+=0.06;
   G4PVPlacement* sh_cp  = new G4PVPlacement(rSh,G4ThreeVector(0,ypos*m,fFC_z/2.*m),
-					    "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, i, true);
+					    "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, i, checkOverlaps);
   sh_cp2  = new G4PVPlacement(rSh2,G4ThreeVector(0,ypos*m,-fFC_z/2.*m),
-			      "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, i+107, true);
+			      "FieldCageShortSlim", fLogicFCShortSlim, fPhysCryostat, false, i+107, checkOverlaps);
       
   G4PVPlacement* sh_cp3  = new G4PVPlacement(rSh,G4ThreeVector(((fFC_x/2.-3.4)+3.4/2)*m,ypos*m,fFC_z/2*m),
-					     "FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, i+215-51, true);
+					     "FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, i+215-51, checkOverlaps);
   sh_cp4  = new G4PVPlacement(rSh2,G4ThreeVector(((fFC_x/2.-3.4)+3.4/2)*m,ypos*m,-fFC_z/2*m),
-			      "FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, i+56+215-51, true);
+			      "FieldCageShortaux", fLogicFCShortaux, fPhysCryostat, false, i+56+215-51, checkOverlaps);
       
   G4PVPlacement* sh_cp5  = new G4PVPlacement(rSh,G4ThreeVector(((-fFC_x/2.+3.4)-3.4/2)*m,ypos*m,fFC_z/2*m),
-					     "FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, i+328-51, true);
+					     "FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, i+328-51, checkOverlaps);
   sh_cp6  = new G4PVPlacement(rSh2,G4ThreeVector(((-fFC_x/2.+3.4)-3.4/2)*m,ypos*m,-fFC_z/2*m),
-			      "FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, i+56+328-51, true);
+			      "FieldCageShortaux2", fLogicFCShortaux2, fPhysCryostat, false, i+56+328-51, checkOverlaps);
  }
+}
 
 
     
+const G4int nEntries = 8;
+//_________ RELEVANT ENERGY VALUES Xe 175nm -> 7.08eV; Ar 128 -> 9.69eV_________
+    G4double PhotonEnergy[nEntries] =
+      { 2.5*eV, 5.0*eV, 7.0*eV, 7.5*eV, 8.0*eV, 9.0*eV, 9.5*eV, 10.136*eV};
+
+//Surfaces setup; lAr-Anode interface
+G4OpticalSurface* AnodeSurface = new G4OpticalSurface("AnodeSurface");
+AnodeSurface->SetType(dielectric_metal);
+AnodeSurface->SetModel(unified);
+AnodeSurface->SetFinish(ground);
+AnodeSurface->SetSigmaAlpha(0.0*deg); // for vikuit
+
+//_______ANODE REFLECTIVITY CHANGE (WITH 40% SOLID AREA) 0.2 -> 0.3*0.4 and 0.0 -> 0.15*0.4______________
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+G4double Anode_r[nEntries] = {0.12, 0.12, 0.12, 0.12, 0.06, 0.06, 0.06, 0.06}; //reflection coef for base
+G4double Anode_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
+// G4double Anode_r[nEntries] = {0.12, 0.12, 0.12, 0.12, 0.06, 0.06, 0.06, 0.06}; //reflection coef for base
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+G4MaterialPropertiesTable* AnodeSurface_pt = new G4MaterialPropertiesTable();
+
+AnodeSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, Anode_r, nEntries);
+AnodeSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, Anode_e, nEntries);
+
+AnodeSurface->SetMaterialPropertiesTable(AnodeSurface_pt);
+new G4LogicalSkinSurface("AnodeSurface", fLogicAnode, AnodeSurface);
+
+G4OpticalSurface* FCSurface = new G4OpticalSurface("FCSurface");
+FCSurface->SetType(dielectric_metal);
+FCSurface->SetModel(unified);
+FCSurface->SetFinish(ground);
+FCSurface->SetSigmaAlpha(0.0*deg); // for vikuit
+
+//_____________________________FC REFLECTIVITY CHANGE 0.2 -> 0.7 ______________________________
+G4double FC_r[nEntries] = {0.7, 0.7, 0.7, 0.7, 0.7, 0.7, 0.7, 0.7,}; //reflection coef for base
+G4double FC_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
+//G4double FC_r[nEntries] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}; //reflection coef for base
+
+G4MaterialPropertiesTable* FCSurface_pt = new G4MaterialPropertiesTable();
+
+FCSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, FC_r, nEntries);
+FCSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, FC_e, nEntries);
+
+FCSurface->SetMaterialPropertiesTable(FCSurface_pt);
+if(fLogicFCShort) new G4LogicalSkinSurface("FCSurfaceShort", fLogicFCShort, FCSurface);
+if(fLogicFCShortSlim) new G4LogicalSkinSurface("FCSurfaceShortSlim", fLogicFCShortSlim, FCSurface);
+new G4LogicalSkinSurface("FCSurfaceSlim", fLogicFCSlim, FCSurface);
+new G4LogicalSkinSurface("FCSurfaceWide", fLogicFCwide, FCSurface);
+
+// CONTAINERS: the field-cage sides moved into LAr boxes, so the cryostat
+// itself has a handful of daughters (the Arapucas are grouped the same
+// way in ConstructArapucas)
+std::vector<G4LogicalVolume*> containers;
+if(fContainers && !fParameterised){
+  std::vector<G4LogicalVolume*> fcLong, fcShort;
+  fcLong.push_back(fLogicFCwide); fcLong.push_back(fLogicFCSlim);
+  fcShort.push_back(fLogicFCShort); fcShort.push_back(fLogicFCShortSlim);
+  fcShort.push_back(fLogicFCShortaux); fcShort.push_back(fLogicFCShortaux2);
+
+  containers.push_back(GroupDaughters(fLogicCryostat, "FieldCageShellP", fcLong, 0, 1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "FieldCageShellM", fcLong, 0, -1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "FieldCageEndP", fcShort, 2, 1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "FieldCageEndM", fcShort, 2, -1));
+}
+
+// _________________ CHANGE NEW CRYOSTAT PROPRTIES _____________________________________
+G4OpticalSurface* CryostatSurface = new G4OpticalSurface("CryostatSurface");
+CryostatSurface->SetType(dielectric_metal);
+CryostatSurface->SetModel(unified);
+CryostatSurface->SetFinish(ground);
+CryostatSurface->SetSigmaAlpha(0.0*deg); // for vikuit
+
+G4double Cryo_r[nEntries] = {0.4, 0.4, 0.4, 0.4, 0.3, 0.3, 0.3, 0.3}; //reflection coef for base
+G4double Cryo_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
+
+G4MaterialPropertiesTable* CryostatSurface_pt = new G4MaterialPropertiesTable();
+
+CryostatSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, Cryo_r, nEntries);
+CryostatSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, Cryo_e, nEntries);
+
+CryostatSurface->SetMaterialPropertiesTable(CryostatSurface_pt);
+new G4LogicalSkinSurface("CryostatSurfaceShort", fLogicCryostat, CryostatSurface);
+for(size_t k=0; k<containers.size(); k++)
+  if(containers[k]) new G4LogicalSkinSurface("CryostatSurface"+containers[k]->GetName(), containers[k], CryostatSurface);
+
+ConstructArapucas(fPhysCryostat, CryostatSurface);
+if(fContainers && !fParameterised)
+  G4cout << "Cryostat daughters after grouping: " << fLogicCryostat->GetNoDaughters() << G4endl;
+
+G4VisAttributes* simpleWorldVisAtt= new G4VisAttributes(G4Colour(1.0,1.0,1.0)); //White
+simpleWorldVisAtt->SetVisibility(true);
+
+//G4VisAttributes* simplePlain= new G4VisAttributes(G4Colour(1.0,1.0,1.0,0.4));
+G4VisAttributes* simplePlain= new G4VisAttributes(G4Colour(1.0,1.0,1.0,0.5)); //White
+simplePlain->SetVisibility(true);
+simplePlain->SetForceSolid(true);
+simplePlain->SetForceAuxEdgeVisible(true);
+
+//G4VisAttributes* simpleBoxAtt= new G4VisAttributes(G4Colour(1.0,1.0,0.0,0.3));
+G4VisAttributes* simpleBoxAtt= new G4VisAttributes(G4Colour(1.0,1.0,0.0,0.5));
+simpleBoxAtt->SetDaughtersInvisible(true);
+simpleBoxAtt->SetForceSolid(true);
+simpleBoxAtt->SetForceAuxEdgeVisible(true);
+
+//  fLogicCathode->SetVisAttributes(simpleBoxAtt);
+//  fLogicAraWindowTop->SetVisAttributes(simpleBoxAttKGM);
+fLogicFCwide->SetVisAttributes(simplePlain);
+if(fLogicFCShortaux) fLogicFCShortaux->SetVisAttributes(simpleBoxAtt);
+if(fLogicFCShortaux2) fLogicFCShortaux2->SetVisAttributes(simpleBoxAtt);
+if(fLogicFCShort) fLogicFCShort->SetVisAttributes(simpleBoxAtt);
+fLogicCathode->SetVisAttributes(simplePlain);
+return fPhysiWorld;
+}
+
+void DetectorConstruction::ConstructArapucas(G4VPhysicalVolume* fPhysCryostat, G4OpticalSurface* CryostatSurface)
+{
+// every cryostat daughter added from here on is part of the Arapuca
+// sub-assemblies (see RebuildArapucas)
+G4int firstDaughter = fLogicCryostat->GetNoDaughters();
+fWindowPlanes.clear();
+fChannels.clear();
+G4int nUnknown = 0; //windows without a channel code in SteppingAction::VolumeCode
+
 //________________________________MEMBRANE ARAPUCAS SHIELDS____________________________________________//
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
-G4double ArapucaOut_y = 0.65;
+G4double ArapucaOut_y = fwindow + 0.05;
 G4double ArapucaOut_x = 0.025;
-G4double ArapucaOut_z = 0.65;
+G4double ArapucaOut_z = fwindow + 0.05;
 G4double ArapucaAcceptanceWindow_x = 0.01;//m
-G4double DistFromCryoWall = 0.1; //m
-int ncol=20, nrows=4;
-double dz=60.0/ncol;
+G4double DistFromCryoWall = fDistFromCryoWall; //m
+int ncol=GetNumberOfPeriods()*fLatColumns, nrows=fLatRows;
+double dz=fPeriod_z/fLatColumns;
 double zpos, xpos, yposBot;
   
 G4Box* ArapucaOut = new G4Box("ArapucaOut",ArapucaOut_x/2*m,ArapucaOut_y/2*m,ArapucaOut_z/2*m);
@@ -371,81 +1257,83 @@ G4RotationMatrix* rWall = new G4RotationMatrix();
 G4ThreeVector* axisWall = new G4ThreeVector(0.0,1.0,0.0);
 rWall->rotate(CLHEP::pi,axisWall);
 xpos=newfCryostat_x/2.0-DistFromCryoWall-ArapucaOut_x/2.0;
-    
-G4VPhysicalVolume* physAraWall = new G4PVPlacement(rWall,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5)*m,(-fCryostat_z/2+dz/2.0)*m),"ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,0, true);
-G4VPhysicalVolume* physAraWall2 = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5)*m,(-fCryostat_z/2+dz/2.0)*m),"ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,0, true);
+G4double xposWall = xpos;
 
-for(int i=1; i<ncol; i++){ //copies of ArapucaWalls on each side (first row)
-  G4PVPlacement* arawall_cp  = new G4PVPlacement(rWall,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5)*m,(-fCryostat_z/2+dz/2.0+i*dz)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,i, true);
-  G4PVPlacement* arawall_cp2  = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5)*m,(-fCryostat_z/2+dz/2.0+i*dz)*m),"ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,i, true);
- }
-G4int ct=ncol; //count of copies for arapucawalls
-for(int i=1; i<ncol; i++){ //19 copies of ArapucaWalls on each side (first row)
-  G4PVPlacement* arawall_cp  = new G4PVPlacement(rWall,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5)*m,
-								     (-fCryostat_z/2+1.5+i*3.0)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,i);//, true);
-  G4PVPlacement* arawall_cp2  = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5)*m,
-								  (-fCryostat_z/2+1.5+i*3.0)*m),  "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,i);//, true);
- }
-ct=20; //count of copies for arapucawalls
-for(int i=1; i<=3; i++){ //other copies of ArapucaWalls on each side (2-4 rows)
-  for(int j=0; j<20;j++){
-    G4PVPlacement* arawallextra_cp  = new G4PVPlacement(rWall,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5-0.8*i)*m,
-									    (-fCryostat_z/2+1.5+j*3.0)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,ct);//, true);
-    G4PVPlacement* arawallextra_cp2  = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5-0.8*i)*m,
-									 (-fCryostat_z/2+1.5+j*3.0)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,ct);//, true);
+if(!fParameterised){ //otherwise the frames are placed inside the modules below
+G4int ct=0; //count of copies for arapucawalls
+for(int i=0; i<nrows; i++){ //rows from the top
+  for(int j=0; j<ncol;j++){
+    G4PVPlacement* arawall_cp  = new G4PVPlacement(rWall,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5-fLatRowPitch*i)*m,
+								     (-fCryostat_z/2+dz/2.0+j*dz)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,ct, checkOverlaps);
+    G4PVPlacement* arawall_cp2  = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5-fLatRowPitch*i)*m,
+								  (-fCryostat_z/2+dz/2.0+j*dz)*m), "ArapucaWalls", fLogicAraWalls, fPhysCryostat, false,ct, checkOverlaps);
     ct++;
   }
  }
+}
 
 //ARAPUCAs
 G4Box* AraWindowLat = new G4Box("ArapucaWindow",ArapucaAcceptanceWindow_x/2*m,fwindow/2*m,fwindow/2*m);
 G4LogicalVolume* fLogicAraWindowLat = new G4LogicalVolume(AraWindowLat,facrylic,"ArapucaWindow");
 
-ncol=20, nrows=4;
 std::string name, physname, name2, physname2;
 xpos=newfCryostat_x/2.0-DistFromCryoWall-ArapucaOut_x+ArapucaAcceptanceWindow_x/2.0+0.001;
+fLatWindow_x = xpos*m;
+
+//parameterised mode: frame and window in one LAr module per channel, the
+//+x modules rotated as the frames are
+G4LogicalVolume* fLogicAraModuleLat = 0;
+ArrayParameterisation* AraLatP = new ArrayParameterisation();
+ArrayParameterisation* AraLatM = new ArrayParameterisation();
+if(fParameterised){
+  fLogicAraModuleLat = new G4LogicalVolume(ArapucaOut,fDefaultMaterial,"ArapucaModuleLat");
+  new G4PVPlacement(0,G4ThreeVector(),fLogicAraWalls,"ArapucaWalls",fLogicAraModuleLat,false,0,checkOverlaps);
+  new G4PVPlacement(0,G4ThreeVector((xposWall-xpos)*m,0.,0.),fLogicAraWindowLat,"ArapucaWindowLat",fLogicAraModuleLat,false,0,checkOverlaps);
+  AraLatP->SetScoringVolume(fLogicAraWindowLat);
+  AraLatM->SetScoringVolume(fLogicAraWindowLat);
+}
 for(int i=0; i<nrows; i++){
   for(int j=0; j<ncol;j++){
-    name = "ArapucaWindowLat"; name.append(std::to_string(i+1)); name.append(std::to_string(j+1));
-    physname = "fPhysAraWindowLat"; physname.append(std::to_string(i+1)); physname.append(std::to_string(j+1));
-    G4VPhysicalVolume* physname = new G4PVPlacement(0,G4ThreeVector(xpos*m,(fCryostat_y/2-0.5-0.8*i)*m,
-								    (-fCryostat_z/2+1.5+j*3.0)*m),name.c_str(), fLogicAraWindowLat, fPhysCryostat, false,0, true);
-    name2 = "ArapucaWindowLlat"; name2.append(std::to_string(i+1)); name2.append(std::to_string(j+1));
-    physname2 = "fPhysAraWindowLlat"; physname2.append(std::to_string(i+1)); physname2.append(std::to_string(j+1));
-    G4VPhysicalVolume* physname2 = new G4PVPlacement(0,G4ThreeVector(-xpos*m,(fCryostat_y/2-0.5-0.8*i)*m,
-								     (-fCryostat_z/2+1.5+j*3.0)*m),name2.c_str(), fLogicAraWindowLat, fPhysCryostat, false,0, true);
-std::cout << name << " " << xpos << " " << (fCryostat_y/2-0.5-0.8*i) << " " << (fCryostat_y/2-0.5-0.8*i) << std::endl;
-std::cout << name2 << " " << -xpos << " " << (fCryostat_y/2-0.5-0.8*i) << " " << (-fCryostat_z/2+1.5+j*3.0) << std::endl;
+    G4double ypos = fCryostat_y/2-0.5-fLatRowPitch*i;
+    zpos = -fCryostat_z/2+dz/2.0+j*dz;
+    name = "ArapucaWindowLat"; name.append(std::to_string(i+1)); name.append(std::to_string(j+1+fLatColumns*fPeriodOffset));
+    physname = "fPhysAraWindowLat"; physname.append(std::to_string(i+1)); physname.append(std::to_string(j+1+fLatColumns*fPeriodOffset));
+    name2 = "ArapucaWindowLlat"; name2.append(std::to_string(i+1)); name2.append(std::to_string(j+1+fLatColumns*fPeriodOffset));
+    physname2 = "fPhysAraWindowLlat"; physname2.append(std::to_string(i+1)); physname2.append(std::to_string(j+1+fLatColumns*fPeriodOffset));
+    if(SteppingAction::VolumeCode(name).first < 0) nUnknown++;
+    if(SteppingAction::VolumeCode(name2).first < 0) nUnknown++;
+    if(fParameterised){
+      AraLatP->AddCopy(G4ThreeVector(xposWall,ypos,zpos)*m, rWall, SteppingAction::VolumeCode(name).first);
+      AraLatM->AddCopy(G4ThreeVector(-xposWall,ypos,zpos)*m, 0, SteppingAction::VolumeCode(name2).first);
+    }else{
+    G4VPhysicalVolume* physname = new G4PVPlacement(0,G4ThreeVector(xpos,ypos,zpos)*m,name.c_str(), fLogicAraWindowLat, fPhysCryostat, false,0, checkOverlaps);
+    G4VPhysicalVolume* physname2 = new G4PVPlacement(0,G4ThreeVector(-xpos,ypos,zpos)*m,name2.c_str(), fLogicAraWindowLat, fPhysCryostat, false,0, checkOverlaps);
+    }
+    AddChannel(name, kLateral, G4ThreeVector(xpos,ypos,zpos)*m, G4ThreeVector(-1.,0.,0.),
+               G4ThreeVector(ArapucaAcceptanceWindow_x/2,fwindow/2,fwindow/2)*m);
+    AddChannel(name2, kLateral, G4ThreeVector(-xpos,ypos,zpos)*m, G4ThreeVector(1.,0.,0.),
+               G4ThreeVector(ArapucaAcceptanceWindow_x/2,fwindow/2,fwindow/2)*m);
   }
  }
+if(fParameterised){
+  PlaceArray("ArapucaLatArrayP", fLogicAraModuleLat, AraLatP, fPhysCryostat);
+  PlaceArray("ArapucaLatArrayM", fLogicAraModuleLat, AraLatM, fPhysCryostat);
+}else{
+  delete AraLatP; delete AraLatM;
+}
 
-//CATHODE
-double cathode[16];
-cathode[0]=-5.5*0.84375;
-cathode[1]=-1.5*0.84375;
-cathode[2]=2.5*0.84375;
-cathode[3]=6.5*0.84375;
-cathode[4]=-7.5*0.84375;
-cathode[5]=-3.5*0.84375;
-cathode[6]=0.5*0.84375;
-cathode[7]=4.5*0.84375;
-cathode[8]=-4.5*0.84375;
-cathode[9]=-0.5*0.84375;
-cathode[10]=3.5*0.84375;
-cathode[11]=7.5*0.84375;
-cathode[12]=-6.5*0.84375;
-cathode[13]=-2.5*0.84375;
-cathode[14]=1.5*0.84375;
-cathode[15]=5.5*0.84375;
+//CATHODE: x of the windows, cycled through in placement order
+const std::vector<G4double>& cathode = fCathodeOffsets;
     
 //________________________________CATHODE ARAPUCAS SHIELDS____________________________________________//
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
-ArapucaOut_x = 0.65;
+ArapucaOut_x = fwindow + 0.05;
 ArapucaOut_y = 0.025;
-ArapucaOut_z = 0.65;
+ArapucaOut_z = fwindow + 0.05;
 G4double ArapucaAcceptanceWindow_y = 0.01;//m
-ncol=40;
-int ncat=8, aux=0, auxcat=0;
+ncol=fCathodeGroups*GetNumberOfPeriods(); //two rows of ncat/2 cathode windows per group
+int ncat=fCathodeWindows, auxcat=0;
+double dzcat=fPeriod_z/(2*fCathodeGroups);
 G4String shield_namecat, shield_physnamecat;
   
 G4Box* ArapucaOutBot = new G4Box("ArapucaOutBot",ArapucaOut_x/2*m,ArapucaOut_y/2*m,ArapucaOut_z/2*m);
@@ -454,71 +1342,86 @@ G4SubtractionSolid* ArapucaBot = new G4SubtractionSolid("ArapucaBot", ArapucaOut
 G4LogicalVolume* fLogicAraBot = new G4LogicalVolume(ArapucaBot,facrylic,"ArapucaBot");
   
 yposBot=-fCryostat_y/2.0+ArapucaOut_y/2.0;
+G4double yposBotWall = yposBot;
   
-    
+if(!fParameterised){ //otherwise the frames are placed inside the modules below
 for(int i=0; i<ncol; i++){
   for(int j=0; j<ncat;j++){
-    shield_namecat = "ArapucaBot"; shield_namecat.append(std::to_string(i+1)); shield_namecat.append(std::to_string(j+1));
-    shield_physnamecat = "fPhysAraBot"; shield_physnamecat.append(std::to_string(i+1)); shield_physnamecat.append(std::to_string(j+1));
-    G4VPhysicalVolume* shield_physnamecat = new G4PVPlacement(0,G4ThreeVector((cathode[auxcat])*m,yposBot*m,
-									      (-fCryostat_z/2+(0.5+i+aux)*0.75)*m),shield_namecat.c_str(), fLogicAraBot, fPhysCryostat, false,0, true);
-    if(j==3) aux++;
-    if(auxcat==15) auxcat=0;
-    else auxcat++;
+    zpos = -fCryostat_z/2+(0.5+2*i+(2*j>=ncat ? 1 : 0))*dzcat;
+    shield_namecat = "ArapucaBot"; shield_namecat.append(std::to_string(i+1+fCathodeGroups*fPeriodOffset)); shield_namecat.append(std::to_string(j+1));
+    shield_physnamecat = "fPhysAraBot"; shield_physnamecat.append(std::to_string(i+1+fCathodeGroups*fPeriodOffset)); shield_physnamecat.append(std::to_string(j+1));
+    G4VPhysicalVolume* shield_physnamecat = new G4PVPlacement(0,G4ThreeVector(cathode[auxcat],yposBot,zpos)*m,shield_namecat.c_str(), fLogicAraBot, fPhysCryostat, false,0, checkOverlaps);
+    auxcat = (auxcat+1) % cathode.size();
   }
  }
+}
     
 G4Box* AraWindowBot = new G4Box("ArapucaWindowBot",fwindow/2*m,ArapucaAcceptanceWindow_y/2*m,fwindow/2*m);
 G4LogicalVolume* fLogicAraWindowBot = new G4LogicalVolume(AraWindowBot,facrylic,"ArapucaWindowBot");
 
-ncol=40;
-ncat=8, aux=0, auxcat=0;
+auxcat=0;
 std::string namecat, physnamecat;
 yposBot=-fCryostat_y/2.0+ArapucaOut_y-ArapucaAcceptanceWindow_y/2.0-0.001;
+fBotWindow_y = yposBot*m;
+
+G4LogicalVolume* fLogicAraModuleBot = 0;
+ArrayParameterisation* AraBot = new ArrayParameterisation();
+if(fParameterised){
+  fLogicAraModuleBot = new G4LogicalVolume(ArapucaOutBot,fDefaultMaterial,"ArapucaModuleBot");
+  new G4PVPlacement(0,G4ThreeVector(),fLogicAraBot,"ArapucaBot",fLogicAraModuleBot,false,0,checkOverlaps);
+  new G4PVPlacement(0,G4ThreeVector(0.,(yposBot-yposBotWall)*m,0.),fLogicAraWindowBot,"ArapucaWindowBot",fLogicAraModuleBot,false,0,checkOverlaps);
+  AraBot->SetScoringVolume(fLogicAraWindowBot);
+}
 for(int i=0; i<ncol; i++){
   for(int j=0; j<ncat;j++){
-    namecat = "ArapucaWindowBot"; namecat.append(std::to_string(i+1)); namecat.append(std::to_string(j+1));
-    physnamecat = "fPhysAraWindowBot"; physnamecat.append(std::to_string(i+1)); physnamecat.append(std::to_string(j+1));
-    G4VPhysicalVolume* physnamecat = new G4PVPlacement(0,G4ThreeVector((cathode[auxcat])*m,yposBot*m,
-								       (-fCryostat_z/2+(0.5+i+aux)*0.75)*m),namecat.c_str(), fLogicAraWindowBot, fPhysCryostat, false,0, true);
-    std::cout << namecat << " " << cathode[auxcat] << " " << yposBot << " " << (-fCryostat_z/2+(0.5+i+aux)*0.75) << std::endl;
-    if(j==3) aux++;
-    if(auxcat==15) auxcat=0;
-    else auxcat++;
+    zpos = -fCryostat_z/2+(0.5+2*i+(2*j>=ncat ? 1 : 0))*dzcat;
+    namecat = "ArapucaWindowBot"; namecat.append(std::to_string(i+1+fCathodeGroups*fPeriodOffset)); namecat.append(std::to_string(j+1));
+    physnamecat = "fPhysAraWindowBot"; physnamecat.append(std::to_string(i+1+fCathodeGroups*fPeriodOffset)); physnamecat.append(std::to_string(j+1));
+    if(SteppingAction::VolumeCode(namecat).first < 0) nUnknown++;
+    if(fParameterised){
+      AraBot->AddCopy(G4ThreeVector(cathode[auxcat],yposBotWall,zpos)*m, 0, SteppingAction::VolumeCode(namecat).first);
+    }else{
+    G4VPhysicalVolume* physnamecat = new G4PVPlacement(0,G4ThreeVector(cathode[auxcat],yposBot,zpos)*m,namecat.c_str(), fLogicAraWindowBot, fPhysCryostat, false,0, checkOverlaps);
+    }
+    AddChannel(namecat, kCathode, G4ThreeVector(cathode[auxcat],yposBot,zpos)*m, G4ThreeVector(0.,1.,0.),
+               G4ThreeVector(fwindow/2,ArapucaAcceptanceWindow_y/2,fwindow/2)*m);
+    auxcat = (auxcat+1) % cathode.size();
   }
  }
-    
+if(fParameterised) PlaceArray("ArapucaBotArray", fLogicAraModuleBot, AraBot, fPhysCryostat);
+else delete AraBot;
+
+//Short lateral Arapucas (none in the periodic geometry)
+G4LogicalVolume* fLogicShortAraWalls = 0;
+G4LogicalVolume* fLogicAraWindowShortLat = 0;
+G4LogicalVolume* fLogicAraModuleShort = 0;
+if(!IsPeriodic()){
 //________________________________ EXTRA MEMBRANE ARAPUCAS SHIELDS____________________________________________//
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
-ArapucaOut_y = 0.65;
+ArapucaOut_y = fwindow + 0.05;
 ArapucaOut_z = 0.025;
-ArapucaOut_x = 0.65;
+ArapucaOut_x = fwindow + 0.05;
 G4double ArapucaAcceptanceWindow_z = 0.01;//m
-DistFromCryoWall = 0.1; //m
+DistFromCryoWall = fDistFromCryoWall; //m
 ncol=2, nrows=4;
  
 G4Box* ShortArapucaOut = new G4Box("ShortArapucaOut",ArapucaOut_x/2*m,ArapucaOut_y/2*m,ArapucaOut_z/2*m);
 G4Box* ShortArapucaIn = new G4Box("ShortArapucaIn",fwindow/2*m,fwindow/2*m,ArapucaOut_z/2*m);
 G4SubtractionSolid* ShortArapucaWalls = new G4SubtractionSolid("ShortArapucaWalls", ShortArapucaOut, ShortArapucaIn, 0, G4ThreeVector(0.,0.,ArapucaOut_z/2*m));
-G4LogicalVolume* fLogicShortAraWalls = new G4LogicalVolume(ShortArapucaWalls,facrylic,"ShortArapucaWalls");
+fLogicShortAraWalls = new G4LogicalVolume(ShortArapucaWalls,facrylic,"ShortArapucaWalls");
 
 zpos=newfCryostat_z/2.0-DistFromCryoWall-ArapucaOut_z/2.0+0.001;
+G4double zposWall = zpos;
  
-G4VPhysicalVolume* physShortAraWall = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20)*m,(fCryostat_y/2-0.5)*m,zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,0, true);
-G4VPhysicalVolume* physShortAraWall2 = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20)*m,(fCryostat_y/2-0.5)*m,-zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,0, true);
+if(!fParameterised){ //otherwise the frames are placed inside the modules below
+G4VPhysicalVolume* physShortAraWall = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20)*m,(fCryostat_y/2-0.5)*m,zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,0, checkOverlaps);
+G4VPhysicalVolume* physShortAraWall2 = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20)*m,(fCryostat_y/2-0.5)*m,-zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,0, checkOverlaps);
 
 for(int i=1; i<ncol; i++){ //copies of ArapucaWalls on each side (first row)
-  G4PVPlacement* Shortarawall_cp  = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,zpos*m), "ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i, true);
-  G4PVPlacement* Shortarawall_cp2  = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,-zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i, true);
+  G4PVPlacement* Shortarawall_cp  = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,zpos*m), "ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i, checkOverlaps);
+  G4PVPlacement* Shortarawall_cp2  = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,-zpos*m),"ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i, checkOverlaps);
  }
-G4int shortct=ncol; //count of copies for arapucawalls
-for(int i=1; i<ncol; i++){ //1 copy of ArapucaWalls on each side (first row)
-  G4PVPlacement* Shortarawall_cp  = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,
-									  zpos*m), "ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i);//, true);
-  G4PVPlacement* Shortarawall_cp2  = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20+i*4.4)*m,(fCryostat_y/2-0.5)*m,
-								       -zpos*m),  "ShortArapucaWalls", fLogicShortAraWalls, fPhysCryostat, false,i);//, true);
- }
-shortct=2; //count of copies for arapucawalls
+G4int shortct=2; //count of copies for arapucawalls
 for(int i=1; i<=3; i++){ //other copies of ArapucaWalls on each side (2-4 rows)
   for(int j=0; j<2;j++){
     G4PVPlacement* Shortarawallextra_cp  = new G4PVPlacement(rWall,G4ThreeVector((-fCryostat_x/2+5.20+j*4.4)*m,(fCryostat_y/2-0.5-0.8*i)*m,
@@ -528,115 +1431,80 @@ for(int i=1; i<=3; i++){ //other copies of ArapucaWalls on each side (2-4 rows)
     shortct++;
   }
  }
+}
 
 //Extra PDs on short laterals
 
 G4Box* AraWindowShortLat = new G4Box("ArapucaWindowShort",fwindow/2*m,fwindow/2*m,ArapucaAcceptanceWindow_z/2*m);
-G4LogicalVolume* fLogicAraWindowShortLat = new G4LogicalVolume(AraWindowShortLat,facrylic,"ArapucaWindowShort");
+fLogicAraWindowShortLat = new G4LogicalVolume(AraWindowShortLat,facrylic,"ArapucaWindowShort");
 
 ncol=2, nrows=4;
 std::string nameshort, physnameshort, nameshort2, physnameshort2;
 zpos=newfCryostat_z/2.0-DistFromCryoWall-ArapucaOut_z+ArapucaAcceptanceWindow_z/2.0+0.001;
+fShortWindow_z = zpos*m;
+
+ArrayParameterisation* AraShortP = new ArrayParameterisation();
+ArrayParameterisation* AraShortM = new ArrayParameterisation();
+if(fParameterised){
+  fLogicAraModuleShort = new G4LogicalVolume(ShortArapucaOut,fDefaultMaterial,"ArapucaModuleShort");
+  new G4PVPlacement(0,G4ThreeVector(),fLogicShortAraWalls,"ShortArapucaWalls",fLogicAraModuleShort,false,0,checkOverlaps);
+  new G4PVPlacement(0,G4ThreeVector(0.,0.,(zposWall-zpos)*m),fLogicAraWindowShortLat,"ArapucaWindowShort",fLogicAraModuleShort,false,0,checkOverlaps);
+  AraShortP->SetScoringVolume(fLogicAraWindowShortLat);
+  AraShortM->SetScoringVolume(fLogicAraWindowShortLat);
+}
 for(int i=0; i<nrows; i++){
   for(int j=0; j<ncol;j++){
     nameshort = "ArapucaWindowShortLat"; nameshort.append(std::to_string(i+1)); nameshort.append(std::to_string(j+1));
     physnameshort = "fPhysAraWindowShortLat"; physnameshort.append(std::to_string(i+1)); physnameshort.append(std::to_string(j+1));
+    nameshort2 = "ArapucaWindowShortlat"; nameshort2.append(std::to_string(i+1)); nameshort2.append(std::to_string(j+1));
+    physnameshort2 = "fPhysAraWindowShortlat"; physnameshort2.append(std::to_string(i+1)); physnameshort2.append(std::to_string(j+1));
+    if(fParameterised){
+      AraShortP->AddCopy(G4ThreeVector((-fCryostat_x/2+5.20+j*4.4)*m,(fCryostat_y/2-0.5-0.8*i)*m,zposWall*m),
+                         rWall, SteppingAction::VolumeCode(nameshort).first);
+      AraShortM->AddCopy(G4ThreeVector((-fCryostat_x/2+5.20+j*4.4)*m,(fCryostat_y/2-0.5-0.8*i)*m,-zposWall*m),
+                         0, SteppingAction::VolumeCode(nameshort2).first);
+    }else{
     G4VPhysicalVolume* physname = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20+j*4.4)*m,(fCryostat_y/2-0.5-0.8*i)*m,
-								    zpos*m),nameshort.c_str(), fLogicAraWindowShortLat, fPhysCryostat, false,0, true);
-
-    nameshort2 = "ArapucaWindowLShortlat"; nameshort2.append(std::to_string(i+1)); nameshort2.append(std::to_string(j+1));
-    physnameshort2 = "fPhysAraWindowLShortlat"; physnameshort2.append(std::to_string(i+1)); physnameshort2.append(std::to_string(j+1));
+								    zpos*m),nameshort.c_str(), fLogicAraWindowShortLat, fPhysCryostat, false,0, checkOverlaps);
     G4VPhysicalVolume* physname2 = new G4PVPlacement(0,G4ThreeVector((-fCryostat_x/2+5.20+j*4.4)*m,(fCryostat_y/2-0.5-0.8*i)*m,
-								     -zpos*m),nameshort2.c_str(), fLogicAraWindowShortLat, fPhysCryostat, false,0, true);
-    std::cout << nameshort << " " << (-fCryostat_x/2+5.20+j*4.4) << " " << (fCryostat_y/2-0.5-0.8*i) << " " << zpos << std::endl;
-    std::cout << nameshort2 << " " << (-fCryostat_x/2+5.20+j*4.4) << " " << (fCryostat_y/2-0.5-0.8*i) << " " << -zpos << std::endl;
+								     -zpos*m),nameshort2.c_str(), fLogicAraWindowShortLat, fPhysCryostat, false,0, checkOverlaps);
+    }
+    AddChannel(nameshort, kShort, G4ThreeVector(-fCryostat_x/2+5.20+j*4.4,fCryostat_y/2-0.5-0.8*i,zpos)*m,
+               G4ThreeVector(0.,0.,-1.), G4ThreeVector(fwindow/2,fwindow/2,ArapucaAcceptanceWindow_z/2)*m);
+    AddChannel(nameshort2, kShort, G4ThreeVector(-fCryostat_x/2+5.20+j*4.4,fCryostat_y/2-0.5-0.8*i,-zpos)*m,
+               G4ThreeVector(0.,0.,1.), G4ThreeVector(fwindow/2,fwindow/2,ArapucaAcceptanceWindow_z/2)*m);
   }
  }
+if(fParameterised){
+  PlaceArray("ArapucaShortArrayP", fLogicAraModuleShort, AraShortP, fPhysCryostat);
+  PlaceArray("ArapucaShortArrayM", fLogicAraModuleShort, AraShortM, fPhysCryostat);
+}else{
+  delete AraShortP; delete AraShortM;
+}
+}
 
+// CONTAINERS: the Arapucas of each wall and the cathode Arapucas moved
+// into LAr boxes (the parameterised arrays are already grouped)
+std::vector<G4LogicalVolume*> containers;
+if(fContainers && !fParameterised){
+  std::vector<G4LogicalVolume*> lat, bot, shortwall;
+  lat.push_back(fLogicAraWalls); lat.push_back(fLogicAraWindowLat);
+  bot.push_back(fLogicAraBot); bot.push_back(fLogicAraWindowBot);
+  shortwall.push_back(fLogicShortAraWalls); shortwall.push_back(fLogicAraWindowShortLat);
+
+  containers.push_back(GroupDaughters(fLogicCryostat, "LateralWallP", lat, 0, 1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "LateralWallM", lat, 0, -1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "ShortWallP", shortwall, 2, 1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "ShortWallM", shortwall, 2, -1));
+  containers.push_back(GroupDaughters(fLogicCryostat, "CathodeLayer", bot, 1, 0));
+}
 
-    
-
-const G4int nEntries = 8;
-//_________ RELEVANT ENERGY VALUES Xe 175nm -> 7.08eV; Ar 128 -> 9.69eV_________
-    G4double PhotonEnergy[nEntries] =
-      { 2.5*eV, 5.0*eV, 7.0*eV, 7.5*eV, 8.0*eV, 9.0*eV, 9.5*eV, 10.136*eV};
-
-//Surfaces setup; lAr-Anode interface
-G4OpticalSurface* AnodeSurface = new G4OpticalSurface("AnodeSurface");
-AnodeSurface->SetType(dielectric_metal);
-AnodeSurface->SetModel(unified);
-AnodeSurface->SetFinish(ground);
-AnodeSurface->SetSigmaAlpha(0.0*deg); // for vikuit
-
-//_______ANODE REFLECTIVITY CHANGE (WITH 40% SOLID AREA) 0.2 -> 0.3*0.4 and 0.0 -> 0.15*0.4______________
-/////////////////////////////////////////////////////////////////////////////////////////////////////////
-G4double Anode_r[nEntries] = {0.12, 0.12, 0.12, 0.12, 0.06, 0.06, 0.06, 0.06}; //reflection coef for base
-G4double Anode_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
-// G4double Anode_r[nEntries] = {0.12, 0.12, 0.12, 0.12, 0.06, 0.06, 0.06, 0.06}; //reflection coef for base
-/////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-G4MaterialPropertiesTable* AnodeSurface_pt = new G4MaterialPropertiesTable();
-
-AnodeSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, Anode_r, nEntries);
-AnodeSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, Anode_e, nEntries);
-
-AnodeSurface->SetMaterialPropertiesTable(AnodeSurface_pt);
-new G4LogicalSkinSurface("AnodeSurface", fLogicAnode, AnodeSurface);
-
-G4OpticalSurface* FCSurface = new G4OpticalSurface("FCSurface");
-FCSurface->SetType(dielectric_metal);
-FCSurface->SetModel(unified);
-FCSurface->SetFinish(ground);
-FCSurface->SetSigmaAlpha(0.0*deg); // for vikuit
-
-//_____________________________FC REFLECTIVITY CHANGE 0.2 -> 0.7 ______________________________
-G4double FC_r[nEntries] = {0.7, 0.7, 0.7, 0.7, 0.7, 0.7, 0.7, 0.7,}; //reflection coef for base
-G4double FC_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
-//G4double FC_r[nEntries] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}; //reflection coef for base
-
-G4MaterialPropertiesTable* FCSurface_pt = new G4MaterialPropertiesTable();
-
-FCSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, FC_r, nEntries);
-FCSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, FC_e, nEntries);
-
-FCSurface->SetMaterialPropertiesTable(FCSurface_pt);
-new G4LogicalSkinSurface("FCSurfaceShort", fLogicFCShort, FCSurface);
-new G4LogicalSkinSurface("FCSurfaceShortSlim", fLogicFCShortSlim, FCSurface);
-new G4LogicalSkinSurface("FCSurfaceSlim", fLogicFCSlim, FCSurface);
-new G4LogicalSkinSurface("FCSurfaceWide", fLogicFCwide, FCSurface);
-
-// _________________ CHANGE NEW CRYOSTAT PROPRTIES _____________________________________
-G4OpticalSurface* CryostatSurface = new G4OpticalSurface("CryostatSurface");
-CryostatSurface->SetType(dielectric_metal);
-CryostatSurface->SetModel(unified);
-CryostatSurface->SetFinish(ground);
-CryostatSurface->SetSigmaAlpha(0.0*deg); // for vikuit
-
-G4double Cryo_r[nEntries] = {0.4, 0.4, 0.4, 0.4, 0.3, 0.3, 0.3, 0.3}; //reflection coef for base
-G4double Cryo_e[nEntries] = {0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0}; //absorption coefficient
-
-G4MaterialPropertiesTable* CryostatSurface_pt = new G4MaterialPropertiesTable();
-
-CryostatSurface_pt->AddProperty("REFLECTIVITY", PhotonEnergy, Cryo_r, nEntries);
-CryostatSurface_pt->AddProperty("EFFICIENCY", PhotonEnergy, Cryo_e, nEntries);
-
-CryostatSurface->SetMaterialPropertiesTable(CryostatSurface_pt);
-new G4LogicalSkinSurface("CryostatSurfaceShort", fLogicCryostat, CryostatSurface);
-
-G4VisAttributes* simpleWorldVisAtt= new G4VisAttributes(G4Colour(1.0,1.0,1.0)); //White
-simpleWorldVisAtt->SetVisibility(true);
-
-//G4VisAttributes* simplePlain= new G4VisAttributes(G4Colour(1.0,1.0,1.0,0.4));
-G4VisAttributes* simplePlain= new G4VisAttributes(G4Colour(1.0,1.0,1.0,0.5)); //White
-simplePlain->SetVisibility(true);
-simplePlain->SetForceSolid(true);
-simplePlain->SetForceAuxEdgeVisible(true);
-
-//G4VisAttributes* simpleBoxAtt= new G4VisAttributes(G4Colour(1.0,1.0,0.0,0.3));
-G4VisAttributes* simpleBoxAtt= new G4VisAttributes(G4Colour(1.0,1.0,0.0,0.5));
-simpleBoxAtt->SetDaughtersInvisible(true);
-simpleBoxAtt->SetForceSolid(true);
-simpleBoxAtt->SetForceAuxEdgeVisible(true);
+//parameterised mode: frames and windows are seen from the module volume
+if(fLogicAraModuleLat) new G4LogicalSkinSurface("CryostatSurfaceModuleLat", fLogicAraModuleLat, CryostatSurface);
+if(fLogicAraModuleBot) new G4LogicalSkinSurface("CryostatSurfaceModuleBot", fLogicAraModuleBot, CryostatSurface);
+if(fLogicAraModuleShort) new G4LogicalSkinSurface("CryostatSurfaceModuleShort", fLogicAraModuleShort, CryostatSurface);
+for(size_t k=0; k<containers.size(); k++)
+  if(containers[k]) new G4LogicalSkinSurface("CryostatSurface"+containers[k]->GetName(), containers[k], CryostatSurface);
 
 G4VisAttributes* simpleBoxAttKGM= new G4VisAttributes(G4Colour(0.0,0.0,1.0,1.0));
 simpleBoxAttKGM->SetVisibility(true);
@@ -649,18 +1517,18 @@ BoxAtt->SetDaughtersInvisible(true);
 BoxAtt->SetForceSolid(true);
 BoxAtt->SetForceAuxEdgeVisible(true);
 
-//  fLogicCathode->SetVisAttributes(simpleBoxAtt);
 fLogicAraWindowLat->SetVisAttributes(simpleBoxAttKGM);
-//  fLogicAraWindowTop->SetVisAttributes(simpleBoxAttKGM);
 fLogicAraWindowBot->SetVisAttributes(simpleBoxAttKGM);
-fLogicAraWindowShortLat->SetVisAttributes(simpleBoxAttKGM);
-fLogicFCwide->SetVisAttributes(simplePlain);
-fLogicFCShortaux->SetVisAttributes(simpleBoxAtt);
-fLogicFCShortaux2->SetVisAttributes(simpleBoxAtt);
-fLogicFCShort->SetVisAttributes(simpleBoxAtt);
-fLogicCathode->SetVisAttributes(simplePlain);
+if(fLogicAraWindowShortLat) fLogicAraWindowShortLat->SetVisAttributes(simpleBoxAttKGM);
 fLogicAraWalls->SetVisAttributes(BoxAtt);
-fLogicShortAraWalls->SetVisAttributes(BoxAtt);
+if(fLogicShortAraWalls) fLogicShortAraWalls->SetVisAttributes(BoxAtt);
 fLogicAraBot->SetVisAttributes(BoxAtt);
-return fPhysiWorld;
+
+if(nUnknown > 0)
+  G4cout << "DetectorConstruction: " << nUnknown << " Arapuca windows of this layout have no channel"
+         << " code in SteppingAction::VolumeCode and are counted as " << SteppingAction::VolumeCode("").first << G4endl;
+
+fArapucaPlacements.clear();
+for(G4int i=firstDaughter; i<fLogicCryostat->GetNoDaughters(); i++)
+  fArapucaPlacements.push_back(fLogicCryostat->GetDaughter(i));
 }
@@ -0,0 +1,205 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "DetectorMessenger.hh"
+
+#include "DetectorConstruction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+DetectorMessenger::DetectorMessenger(DetectorConstruction* det)
+:G4UImessenger(),fDetector(det),
+ fDetDir(0),fPeriodsCmd(0),fParamCmd(0),fContainersCmd(0),fFieldCageCmd(0),
+ fGdmlCacheCmd(0),fWriteGdmlCmd(0),fSmartlessCmd(0),fVoxeliseCmd(0),
+ fVoxelStatsCmd(0),fNavStatsCmd(0),fChannelMapCmd(0),
+ fActiveCutCmd(0),fArapucaCutCmd(0),fOuterCutCmd(0),fOuterMinEkinCmd(0)
+{
+  fDetDir = new G4UIdirectory("/testem/det/");
+  fDetDir->SetGuidance("Detector geometry");
+
+  fPeriodsCmd = new G4UIcmdWithAnInteger("/testem/det/periods",this);
+  fPeriodsCmd->SetGuidance("Build n periods (3 m in z) of the detector with periodic ends");
+  fPeriodsCmd->SetGuidance("Window names and codes stay those of the full detector;");
+  fPeriodsCmd->SetGuidance("0 builds the full detector.");
+  fPeriodsCmd->SetParameterName("n",false);
+  fPeriodsCmd->SetRange("n>=0 && n<=20");
+  fPeriodsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fParamCmd = new G4UIcmdWithABool("/testem/det/parameterised",this);
+  fParamCmd->SetGuidance("Build the Arapuca modules and long field-cage profiles");
+  fParamCmd->SetGuidance("as parameterised arrays (channel from the copy number).");
+  fParamCmd->SetParameterName("flag",true);
+  fParamCmd->SetDefaultValue(true);
+  fParamCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fContainersCmd = new G4UIcmdWithABool("/testem/det/containers",this);
+  fContainersCmd->SetGuidance("Group the Arapucas and field-cage profiles in LAr");
+  fContainersCmd->SetGuidance("container volumes (fewer daughters of the cryostat).");
+  fContainersCmd->SetParameterName("flag",true);
+  fContainersCmd->SetDefaultValue(true);
+  fContainersCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fFieldCageCmd = new G4UIcmdWithAString("/testem/det/fieldCageShape",this);
+  fFieldCageCmd->SetGuidance("Solid of the field-cage profiles: exact (elliptical tube");
+  fFieldCageCmd->SetGuidance("minus box), polygon (extruded polygon on the same outline)");
+  fFieldCageCmd->SetGuidance("or slab (thin box, same shadow and reflective perimeter).");
+  fFieldCageCmd->SetParameterName("shape",false);
+  fFieldCageCmd->SetCandidates("exact polygon slab");
+  fFieldCageCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fGdmlCacheCmd = new G4UIcmdWithAString("/testem/det/gdmlCache",this);
+  fGdmlCacheCmd->SetGuidance("Directory of cached GDML geometries, none to disable.");
+  fGdmlCacheCmd->SetGuidance("The first construction reads fd2_<key>.gdml from it if");
+  fGdmlCacheCmd->SetGuidance("present (key: hash of the geometry parameters), later");
+  fGdmlCacheCmd->SetGuidance("constructions write missing ones. Use g4workshop");
+  fGdmlCacheCmd->SetGuidance("--gdml-cache=dir to have it before /run/initialize.");
+  fGdmlCacheCmd->SetParameterName("dir",false);
+  fGdmlCacheCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fWriteGdmlCmd = new G4UIcmdWithAString("/testem/det/writeGdml",this);
+  fWriteGdmlCmd->SetGuidance("Write the current geometry to a GDML file");
+  fWriteGdmlCmd->SetParameterName("file",false);
+  fWriteGdmlCmd->AvailableForStates(G4State_Idle);
+
+  fSmartlessCmd = new G4UIcmdWithADouble("/testem/det/smartless",this);
+  fSmartlessCmd->SetGuidance("Smartless of the cryostat voxels: average number of");
+  fSmartlessCmd->SetGuidance("slices per daughter (Geant4 default 2). Larger values");
+  fSmartlessCmd->SetGuidance("give finer voxels and fewer daughters per node.");
+  fSmartlessCmd->SetParameterName("smartless",false);
+  fSmartlessCmd->SetRange("smartless>0");
+  fSmartlessCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fVoxeliseCmd = new G4UIcmdWithABool("/testem/det/voxelise",this);
+  fVoxeliseCmd->SetGuidance("Build smart voxels for the cryostat (false: every");
+  fVoxeliseCmd->SetGuidance("daughter is tested at each step).");
+  fVoxeliseCmd->SetParameterName("flag",true);
+  fVoxeliseCmd->SetDefaultValue(true);
+  fVoxeliseCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fVoxelStatsCmd = new G4UIcmdWithoutParameter("/testem/det/voxelStats",this);
+  fVoxelStatsCmd->SetGuidance("Print the voxel statistics of the cryostat and its containers");
+  fVoxelStatsCmd->SetGuidance("(geometry closed, i.e. after a run).");
+  fVoxelStatsCmd->AvailableForStates(G4State_Idle);
+
+  fNavStatsCmd = new G4UIcmdWithABool("/testem/det/navStats",this);
+  fNavStatsCmd->SetGuidance("Print the voxel statistics at run start and the mean number");
+  fNavStatsCmd->SetGuidance("of daughters tested per step at run end.");
+  fNavStatsCmd->SetParameterName("flag",true);
+  fNavStatsCmd->SetDefaultValue(true);
+  fNavStatsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fChannelMapCmd = new G4UIcmdWithAString("/testem/det/channelMap",this);
+  fChannelMapCmd->SetGuidance("CSV file of the channel map (id, name, group, window centre,");
+  fChannelMapCmd->SetGuidance("normal and size), written after each construction; none to");
+  fChannelMapCmd->SetGuidance("disable. In Idle state the current map is also written at once.");
+  fChannelMapCmd->SetParameterName("file",false);
+  fChannelMapCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fActiveCutCmd = new G4UIcmdWithADoubleAndUnit("/testem/det/activeCut",this);
+  fActiveCutCmd->SetGuidance("Production cut in the ActiveLAr region (the cryostat)");
+  fActiveCutCmd->SetParameterName("cut",false);
+  fActiveCutCmd->SetRange("cut>0.");
+  fActiveCutCmd->SetUnitCategory("Length");
+  fActiveCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fArapucaCutCmd = new G4UIcmdWithADoubleAndUnit("/testem/det/arapucaCut",this);
+  fArapucaCutCmd->SetGuidance("Production cut in the Arapuca region (frames and windows)");
+  fArapucaCutCmd->SetParameterName("cut",false);
+  fArapucaCutCmd->SetRange("cut>0.");
+  fArapucaCutCmd->SetUnitCategory("Length");
+  fArapucaCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fOuterCutCmd = new G4UIcmdWithADoubleAndUnit("/testem/det/outerCut",this);
+  fOuterCutCmd->SetGuidance("Production cut in the Outer region (cryostat shell) and the world");
+  fOuterCutCmd->SetParameterName("cut",false);
+  fOuterCutCmd->SetRange("cut>0.");
+  fOuterCutCmd->SetUnitCategory("Length");
+  fOuterCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fOuterMinEkinCmd = new G4UIcmdWithADoubleAndUnit("/testem/det/outerMinEkin",this);
+  fOuterMinEkinCmd->SetGuidance("Electrons and positrons below this energy are killed in the");
+  fOuterMinEkinCmd->SetGuidance("Outer region and the world (0 to keep them).");
+  fOuterMinEkinCmd->SetParameterName("ekin",false);
+  fOuterMinEkinCmd->SetRange("ekin>=0.");
+  fOuterMinEkinCmd->SetUnitCategory("Energy");
+  fOuterMinEkinCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+DetectorMessenger::~DetectorMessenger()
+{
+  delete fPeriodsCmd;
+  delete fParamCmd;
+  delete fContainersCmd;
+  delete fFieldCageCmd;
+  delete fGdmlCacheCmd;
+  delete fWriteGdmlCmd;
+  delete fSmartlessCmd;
+  delete fVoxeliseCmd;
+  delete fVoxelStatsCmd;
+  delete fNavStatsCmd;
+  delete fChannelMapCmd;
+  delete fActiveCutCmd;
+  delete fArapucaCutCmd;
+  delete fOuterCutCmd;
+  delete fOuterMinEkinCmd;
+  delete fDetDir;
+}
+
+void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fPeriodsCmd)
+    { fDetector->SetPeriods(fPeriodsCmd->GetNewIntValue(newValue));}
+
+  if (command == fParamCmd)
+    { fDetector->SetParameterised(fParamCmd->GetNewBoolValue(newValue));}
+
+  if (command == fContainersCmd)
+    { fDetector->SetContainers(fContainersCmd->GetNewBoolValue(newValue));}
+
+  if (command == fFieldCageCmd)
+    { fDetector->SetFieldCageShape(newValue == "polygon" ? DetectorConstruction::kFieldCagePolygon :
+                                   newValue == "slab" ? DetectorConstruction::kFieldCageSlab :
+                                   DetectorConstruction::kFieldCageExact);}
+
+  if (command == fGdmlCacheCmd)
+    { fDetector->SetGdmlCache(newValue == "none" ? G4String() : newValue);}
+
+  if (command == fWriteGdmlCmd)
+    { fDetector->WriteGdml(newValue);}
+
+  if (command == fSmartlessCmd)
+    { fDetector->SetSmartless(fSmartlessCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fVoxeliseCmd)
+    { fDetector->SetVoxelise(fVoxeliseCmd->GetNewBoolValue(newValue));}
+
+  if (command == fVoxelStatsCmd)
+    { fDetector->PrintVoxelStats();}
+
+  if (command == fNavStatsCmd)
+    { fDetector->SetNavigationStats(fNavStatsCmd->GetNewBoolValue(newValue));}
+
+  if (command == fChannelMapCmd)
+    { fDetector->SetChannelMapFile(newValue == "none" ? G4String() : newValue);
+      if (newValue != "none" && !fDetector->GetChannels().empty()) fDetector->WriteChannelMap(newValue);}
+
+  if (command == fActiveCutCmd)
+    { fDetector->SetRegionCut("ActiveLAr", fActiveCutCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fArapucaCutCmd)
+    { fDetector->SetRegionCut("Arapuca", fArapucaCutCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fOuterCutCmd)
+    { fDetector->SetRegionCut("Outer", fOuterCutCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fOuterMinEkinCmd)
+    { fDetector->SetOuterMinEkin(fOuterMinEkinCmd->GetNewDoubleValue(newValue));}
+}
@@ -0,0 +1,195 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "EMShowerModel.hh"
+#include "EMShowerModelMessenger.hh"
+#include "PhysicsList.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Gamma.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4RunManager.hh"
+#include "G4Poisson.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  G4ThreeVector Isotropic()
+  {
+    G4double cost = 2.*G4UniformRand() - 1.;
+    G4double sint = std::sqrt(1. - cost*cost);
+    G4double phi = twopi*G4UniformRand();
+    return G4ThreeVector(sint*std::cos(phi), sint*std::sin(phi), cost);
+  }
+
+  // unit vector perpendicular to d at a random azimuth
+  G4ThreeVector Perpendicular(const G4ThreeVector& d)
+  {
+    G4ThreeVector a = d.orthogonal().unit();
+    G4ThreeVector b = a.cross(d).unit();
+    G4double phi = twopi*G4UniformRand();
+    return std::cos(phi)*a + std::sin(phi)*b;
+  }
+
+  G4double ConstProperty(G4MaterialPropertiesTable* mpt, const char* name, G4double value)
+  {
+    return mpt->ConstPropertyExists(name) ? mpt->GetConstProperty(name) : value;
+  }
+}
+
+EMShowerModel::EMShowerModel(const G4String& name, G4Region* region)
+:G4VFastSimulationModel(name, region),fMessenger(0),fNavigator(0),
+ fActive(false),fMinEnergy(20.*MeV),fSpotEnergy(1.*MeV)
+{
+  fMessenger = new EMShowerModelMessenger(this);
+  fNavigator = new G4Navigator();
+}
+
+EMShowerModel::~EMShowerModel()
+{
+  delete fMessenger;
+  delete fNavigator;
+}
+
+G4bool EMShowerModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Electron::ElectronDefinition() ||
+         &particle == G4Positron::PositronDefinition() ||
+         &particle == G4Gamma::GammaDefinition();
+}
+
+G4bool EMShowerModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  if(!fActive) return false;
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  if(track->GetKineticEnergy() < fMinEnergy) return false;
+
+  // only in a scintillator, not in the field cage or anode of the region
+  G4MaterialPropertiesTable* mpt = track->GetMaterial()->GetMaterialPropertiesTable();
+  return mpt && mpt->ConstPropertyExists("SCINTILLATIONYIELD") &&
+         (mpt->GetProperty("FASTCOMPONENT") || mpt->GetProperty("SLOWCOMPONENT"));
+}
+
+void EMShowerModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4Material* material = track->GetMaterial();
+  G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+  G4double energy = track->GetKineticEnergy();
+
+  // shower scales: Ec of liquids and solids, Moliere radius
+  G4double x0 = material->GetRadlen();
+  G4double z = material->GetTotNbOfElectPerVolume()/material->GetTotNbOfAtomsPerVolume();
+  G4double ec = 610.*MeV/(z + 1.24);
+  G4double rm = 21.2052*MeV*x0/ec;
+  const G4double b = 0.5;
+  G4double a = 1. + b*std::max(std::log(energy/ec) - 0.5, 0.);
+
+  const G4ThreeVector& dir = track->GetMomentumDirection();
+  G4ThreeVector start = track->GetPosition();
+  if(track->GetDefinition() == G4Gamma::GammaDefinition())
+    start += CLHEP::RandExponential::shoot(9./7.*x0)*dir;
+
+  // world of the tracking, replaced by full geometry rebuilds
+  G4VPhysicalVolume* world =
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if(fNavigator->GetWorldVolume() != world) fNavigator->SetWorldVolume(world);
+
+  const PhysicsList* physics =
+    static_cast<const PhysicsList*>(G4RunManager::GetRunManager()->GetUserPhysicsList());
+  G4double f = physics ? physics->GetOpticalYieldScale() : 1.;
+  G4double yield = f*mpt->GetConstProperty("SCINTILLATIONYIELD");
+  G4double resolution = ConstProperty(mpt, "RESOLUTIONSCALE", 1.);
+
+  G4int nSpots = std::max(1, G4int(std::ceil(energy/fSpotEnergy)));
+  G4double spotEnergy = energy/nSpots;
+  G4int nPhotons = 0;
+  fSpots.clear();
+  for(G4int i=0; i<nSpots; i++){
+    G4double depth = CLHEP::RandGamma::shoot(a, b)*x0;
+    G4double u = G4UniformRand();
+    G4double r = rm/3.*std::sqrt(u/(1. - u));
+    Spot spot;
+    spot.position = start + depth*dir + r*Perpendicular(dir);
+    spot.time = track->GetGlobalTime() + (spot.position - track->GetPosition()).mag()/c_light;
+
+    // no light from the spots outside the scintillator
+    G4VPhysicalVolume* pv = fNavigator->LocateGlobalPointAndSetup(spot.position, 0, false, true);
+    if(!pv || pv->GetLogicalVolume()->GetMaterial() != material) continue;
+
+    G4double mean = yield*spotEnergy;
+    if(mean > 10.) spot.nPhotons = G4int(G4RandGauss::shoot(mean, resolution*std::sqrt(mean)) + 0.5);
+    else spot.nPhotons = G4int(G4Poisson(mean));
+    if(spot.nPhotons <= 0) continue;
+    nPhotons += spot.nPhotons;
+    fSpots.push_back(spot);
+  }
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fastStep.ProposeTotalEnergyDeposited(energy);
+  fastStep.SetNumberOfSecondaryTracks(nPhotons);
+
+  const G4MaterialPropertyVector* fast = mpt->GetProperty("FASTCOMPONENT");
+  const G4MaterialPropertyVector* slow = mpt->GetProperty("SLOWCOMPONENT");
+  G4double fastFraction = fast ? (slow ? ConstProperty(mpt, "YIELDRATIO", 1.) : 1.) : 0.;
+  G4double fastTime = ConstProperty(mpt, "FASTTIMECONSTANT", 0.);
+  G4double slowTime = ConstProperty(mpt, "SLOWTIMECONSTANT", 0.);
+  G4double weight = (f < 1.) ? 1./f : 1.;
+
+  for(size_t i=0; i<fSpots.size(); i++){
+    for(G4int k=0; k<fSpots[i].nPhotons; k++){
+      G4bool isFast = G4UniformRand() < fastFraction;
+      G4double tau = isFast ? fastTime : slowTime;
+      G4double time = fSpots[i].time - tau*std::log(1. - G4UniformRand());
+
+      G4ThreeVector photonDir = Isotropic();
+      G4DynamicParticle photon(G4OpticalPhoton::OpticalPhotonDefinition(), photonDir,
+                               SampleEnergy(isFast ? fast : slow));
+      G4ThreeVector polarisation = Perpendicular(photonDir);
+      photon.SetPolarization(polarisation.x(), polarisation.y(), polarisation.z());
+
+      G4Track* secondary = fastStep.CreateSecondaryTrack(photon, fSpots[i].position, time, false);
+      secondary->SetWeight(weight);
+    }
+  }
+}
+
+G4double EMShowerModel::SampleEnergy(const G4MaterialPropertyVector* spectrum)
+{
+  size_t n = spectrum->GetVectorLength();
+  if(n == 1) return spectrum->Energy(0);
+
+  // cumulative of the piecewise-linear spectrum, built once per vector
+  std::vector<G4double>& integral = fIntegrals[spectrum];
+  if(integral.empty()){
+    integral.push_back(0.);
+    for(size_t i=1; i<n; i++)
+      integral.push_back(integral.back() + 0.5*((*spectrum)[i-1] + (*spectrum)[i])*
+                         (spectrum->Energy(i) - spectrum->Energy(i-1)));
+  }
+
+  G4double x = G4UniformRand()*integral.back();
+  size_t i = std::upper_bound(integral.begin(), integral.end(), x) - integral.begin();
+  i = std::max(size_t(1), std::min(i, n-1));
+  G4double width = integral[i] - integral[i-1];
+  G4double frac = (width > 0.) ? (x - integral[i-1])/width : 0.;
+  return spectrum->Energy(i-1) + frac*(spectrum->Energy(i) - spectrum->Energy(i-1));
+}
@@ -0,0 +1,58 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "EMShowerModelMessenger.hh"
+
+#include "EMShowerModel.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+EMShowerModelMessenger::EMShowerModelMessenger(EMShowerModel* model)
+:G4UImessenger(),fModel(model),
+ fShowerDir(0),fActiveCmd(0),fMinEnergyCmd(0),fSpotEnergyCmd(0)
+{
+  fShowerDir = new G4UIdirectory("/testem/shower/");
+  fShowerDir->SetGuidance("Parameterised EM showers in the LAr");
+
+  fActiveCmd = new G4UIcmdWithABool("/testem/shower/active",this);
+  fActiveCmd->SetGuidance("Replace e-, e+ and gammas above minEnergy by a parameterised");
+  fActiveCmd->SetGuidance("shower giving the scintillation photons directly");
+  fActiveCmd->SetParameterName("flag",true);
+  fActiveCmd->SetDefaultValue(true);
+
+  fMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/testem/shower/minEnergy",this);
+  fMinEnergyCmd->SetGuidance("Kinetic energy above which showers are parameterised");
+  fMinEnergyCmd->SetParameterName("energy",false);
+  fMinEnergyCmd->SetRange("energy>0.");
+  fMinEnergyCmd->SetUnitCategory("Energy");
+
+  fSpotEnergyCmd = new G4UIcmdWithADoubleAndUnit("/testem/shower/spotEnergy",this);
+  fSpotEnergyCmd->SetGuidance("Energy deposited per spot of the shower profile");
+  fSpotEnergyCmd->SetParameterName("energy",false);
+  fSpotEnergyCmd->SetRange("energy>0.");
+  fSpotEnergyCmd->SetUnitCategory("Energy");
+}
+
+EMShowerModelMessenger::~EMShowerModelMessenger()
+{
+  delete fActiveCmd;
+  delete fMinEnergyCmd;
+  delete fSpotEnergyCmd;
+  delete fShowerDir;
+}
+
+void EMShowerModelMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fActiveCmd)
+    { fModel->SetActive(fActiveCmd->GetNewBoolValue(newValue));}
+
+  if (command == fMinEnergyCmd)
+    { fModel->SetMinEnergy(fMinEnergyCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fSpotEnergyCmd)
+    { fModel->SetSpotEnergy(fSpotEnergyCmd->GetNewDoubleValue(newValue));}
+}
@@ -0,0 +1,146 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "FastOpBoundaryProcess.hh"
+#include "OpticalConstants.hh"
+
+#include "G4OpticalSurface.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4RandomTools.hh"
+#include "Randomize.hh"
+
+FastOpBoundaryProcess::FastOpBoundaryProcess(const G4String& processName)
+:G4OpBoundaryProcess(processName),fConstants(0),
+ fFastPath(true),fLastFast(false),fFastStatus(Undefined)
+{}
+
+FastOpBoundaryProcess::~FastOpBoundaryProcess()
+{}
+
+G4OpBoundaryProcessStatus FastOpBoundaryProcess::GetStatus() const
+{
+  return fLastFast ? fFastStatus : G4OpBoundaryProcess::GetStatus();
+}
+
+FastOpBoundaryProcess::SurfaceData&
+FastOpBoundaryProcess::GetSurfaceData(const G4OpticalSurface* surface)
+{
+  std::map<const G4OpticalSurface*, SurfaceData>::iterator it = fSurfaceData.find(surface);
+  if(it != fSurfaceData.end()) return it->second;
+
+  SurfaceData data;
+  data.fast = false;
+  data.reflectivity = 0;
+  data.lineEnergy = 0.;
+  data.lineReflectivity = 1.;
+
+  G4MaterialPropertiesTable* mpt = surface->GetMaterialPropertiesTable();
+  if(surface->GetType() == dielectric_metal && surface->GetModel() == unified &&
+     surface->GetFinish() == ground && mpt){
+    G4MaterialPropertyVector* eff = mpt->GetProperty("EFFICIENCY");
+    data.fast = !mpt->GetProperty("SPECULARLOBECONSTANT") &&
+                !mpt->GetProperty("SPECULARSPIKECONSTANT") &&
+                !mpt->GetProperty("BACKSCATTERCONSTANT") &&
+                !mpt->GetProperty("TRANSMITTANCE") &&
+                !mpt->GetProperty("REALRINDEX") &&
+                !mpt->GetProperty("IMAGINARYRINDEX") &&
+                (!eff || eff->GetMaxValue() <= 0.);
+    data.reflectivity = mpt->GetProperty("REFLECTIVITY");
+  }
+  return fSurfaceData[surface] = data;
+}
+
+G4bool FastOpBoundaryProcess::HasRindex(const G4Material* material)
+{
+  std::map<const G4Material*, G4bool>::iterator it = fHasRindex.find(material);
+  if(it != fHasRindex.end()) return it->second;
+
+  G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+  return fHasRindex[material] = (mpt && mpt->GetProperty("RINDEX"));
+}
+
+G4VParticleChange* FastOpBoundaryProcess::PostStepDoIt(const G4Track& aTrack,
+                                                       const G4Step& aStep)
+{
+  fLastFast = false;
+  if(!fFastPath) return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  // the cases G4OpBoundaryProcess sorts out before looking at the surface
+  const G4StepPoint* pre = aStep.GetPreStepPoint();
+  const G4StepPoint* post = aStep.GetPostStepPoint();
+  if(post->GetStepStatus() != fGeomBoundary ||
+     aTrack.GetStepLength() <= 0.5*G4GeometryTolerance::GetInstance()->GetSurfaceTolerance() ||
+     pre->GetMaterial() == post->GetMaterial() || !HasRindex(pre->GetMaterial()))
+    return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  // same surface lookup as G4OpBoundaryProcess
+  G4VPhysicalVolume* prePV = pre->GetPhysicalVolume();
+  G4VPhysicalVolume* postPV = post->GetPhysicalVolume();
+  if(G4LogicalBorderSurface::GetSurface(prePV, postPV))
+    return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  G4LogicalSkinSurface* skin = 0;
+  if(postPV->GetMotherLogical() == prePV->GetLogicalVolume()){
+    skin = G4LogicalSkinSurface::GetSurface(postPV->GetLogicalVolume());
+    if(!skin) skin = G4LogicalSkinSurface::GetSurface(prePV->GetLogicalVolume());
+  }else{
+    skin = G4LogicalSkinSurface::GetSurface(prePV->GetLogicalVolume());
+    if(!skin) skin = G4LogicalSkinSurface::GetSurface(postPV->GetLogicalVolume());
+  }
+  const G4OpticalSurface* surface =
+    skin ? dynamic_cast<const G4OpticalSurface*>(skin->GetSurfaceProperty()) : 0;
+  if(!surface) return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  SurfaceData& data = GetSurfaceData(surface);
+  if(!data.fast) return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  G4bool valid;
+  G4Navigator* navigator =
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  G4ThreeVector normal = -navigator->GetGlobalExitNormal(post->GetPosition(), &valid);
+  G4ThreeVector oldMomentum = aTrack.GetMomentumDirection();
+  if(!valid || oldMomentum*normal > 0.)
+    return G4OpBoundaryProcess::PostStepDoIt(aTrack, aStep);
+
+  aParticleChange.Initialize(aTrack);
+  aParticleChange.ProposeVelocity(aTrack.GetVelocity());
+  fLastFast = true;
+
+  G4double energy = aTrack.GetDynamicParticle()->GetTotalMomentum();
+  G4double reflectivity = 1.;
+  if(fConstants && fConstants->IsLine(energy)){
+    if(data.lineEnergy != fConstants->GetEnergy()){
+      data.lineEnergy = fConstants->GetEnergy();
+      data.lineReflectivity = data.reflectivity ? data.reflectivity->Value(data.lineEnergy) : 1.;
+    }
+    reflectivity = data.lineReflectivity;
+  }else if(data.reflectivity){
+    reflectivity = data.reflectivity->Value(energy);
+  }
+
+  if(G4UniformRand() > reflectivity){
+    fFastStatus = Absorption;
+    // as G4OpBoundaryProcess::DoAbsorption: the skins have no EFFICIENCY,
+    // so nothing is detected and nothing deposited
+    aParticleChange.ProposeLocalEnergyDeposit(0.);
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+  }else{
+    fFastStatus = LambertianReflection;
+    G4ThreeVector newMomentum = G4LambertianRand(normal);
+    G4ThreeVector facetNormal = (newMomentum - oldMomentum).unit();
+    G4ThreeVector oldPolarization = aTrack.GetPolarization();
+    G4ThreeVector newPolarization =
+      -oldPolarization + (2.*(oldPolarization*facetNormal))*facetNormal;
+    aParticleChange.ProposeMomentumDirection(newMomentum);
+    aParticleChange.ProposePolarization(newPolarization);
+  }
+
+  return G4VDiscreteProcess::PostStepDoIt(aTrack, aStep);
+}
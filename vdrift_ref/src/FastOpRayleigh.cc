@@ -0,0 +1,37 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "FastOpRayleigh.hh"
+
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+FastOpRayleigh::FastOpRayleigh(OpticalConstants* constants, const G4String& processName)
+:OpRayleighMono(constants, processName),fFastSampling(true)
+{}
+
+FastOpRayleigh::~FastOpRayleigh()
+{}
+
+G4VParticleChange* FastOpRayleigh::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
+{
+  if(!fFastSampling) return G4OpRayleigh::PostStepDoIt(aTrack, aStep);
+
+  aParticleChange.Initialize(aTrack);
+
+  const G4DynamicParticle* particle = aTrack.GetDynamicParticle();
+  G4double rand[3];
+  CLHEP::HepRandom::getTheEngine()->flatArray(3, rand);
+
+  G4ThreeVector newDir, newPol;
+  fSampler.Scatter(particle->GetMomentumDirection(), particle->GetPolarization(),
+                   rand, newDir, newPol);
+
+  aParticleChange.ProposeMomentumDirection(newDir);
+  aParticleChange.ProposePolarization(newPol);
+
+  return G4VDiscreteProcess::PostStepDoIt(aTrack, aStep);
+}
@@ -0,0 +1,258 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "GeometryValidator.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <thread>
+#include <atomic>
+#include <set>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+GeometryValidator::GeometryValidator(G4int resolution, G4double tolerance, G4int nThreads)
+:fResolution(resolution),fTolerance(tolerance),fNThreads(nThreads),fNPlacements(0)
+{
+  if(fNThreads <= 0) fNThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+GeometryValidator::~GeometryValidator()
+{}
+
+const std::vector<G4ThreeVector>& GeometryValidator::SurfacePoints(const G4VSolid* solid)
+{
+  std::vector<G4ThreeVector>& points = fPoints[solid];
+  if(points.empty()){
+    points.reserve(fResolution);
+    for(G4int i=0; i<fResolution; i++) points.push_back(solid->GetPointOnSurface());
+  }
+  return points;
+}
+
+void GeometryValidator::CollectPlacements(const G4LogicalVolume* mother, std::vector<Placement>& list)
+{
+  for(G4int i=0; i<mother->GetNoDaughters(); i++){
+    G4VPhysicalVolume* pv = mother->GetDaughter(i);
+    G4VPVParameterisation* param = pv->GetParameterisation();
+    if(pv->IsReplicated() && !param) continue;  // replicas cannot overlap by construction
+
+    G4int nCopies = param ? pv->GetMultiplicity() : 1;
+    for(G4int copy=0; copy<nCopies; copy++){
+      Placement p;
+      p.solid = pv->GetLogicalVolume()->GetSolid();
+      if(param){
+        param->ComputeTransformation(copy, pv);
+        G4VSolid* solid = param->ComputeSolid(copy, pv);
+        if(solid) p.solid = solid;
+      }
+      p.name = &pv->GetName();
+      p.copy = param ? copy : pv->GetCopyNo();
+      p.toMother = G4AffineTransform(pv->GetRotation(), pv->GetTranslation());
+      p.fromMother = p.toMother.Inverse();
+      p.duplicateOf = -1;
+
+      G4VisExtent extent = p.solid->GetExtent();
+      p.lo = G4ThreeVector(DBL_MAX,DBL_MAX,DBL_MAX);
+      p.hi = -p.lo;
+      for(G4int c=0; c<8; c++){
+        G4ThreeVector corner((c & 1) ? extent.GetXmax() : extent.GetXmin(),
+                             (c & 2) ? extent.GetYmax() : extent.GetYmin(),
+                             (c & 4) ? extent.GetZmax() : extent.GetZmin());
+        corner = p.toMother.TransformPoint(corner);
+        for(G4int a=0; a<3; a++){
+          p.lo[a] = std::min(p.lo[a], corner[a]);
+          p.hi[a] = std::max(p.hi[a], corner[a]);
+        }
+      }
+      SurfacePoints(p.solid);  // sampled here, the threads only read them
+      list.push_back(p);
+    }
+  }
+}
+
+void GeometryValidator::FindDuplicates(std::vector<Placement>& list)
+{
+  // same solid, same rotation and translation to 1 nm
+  typedef std::pair<const G4VSolid*, std::vector<long long> > Key;
+  std::map<Key, G4int> seen;
+  for(size_t i=0; i<list.size(); i++){
+    const G4ThreeVector t = list[i].toMother.NetTranslation();
+    const G4RotationMatrix r = list[i].toMother.NetRotation();
+    std::vector<long long> values;
+    for(G4int a=0; a<3; a++) values.push_back(std::llround(t[a]/(1.e-6*mm)));
+    values.push_back(std::llround(r.xx()*1.e9)); values.push_back(std::llround(r.xy()*1.e9));
+    values.push_back(std::llround(r.xz()*1.e9)); values.push_back(std::llround(r.yx()*1.e9));
+    values.push_back(std::llround(r.yy()*1.e9)); values.push_back(std::llround(r.yz()*1.e9));
+    values.push_back(std::llround(r.zx()*1.e9)); values.push_back(std::llround(r.zy()*1.e9));
+    values.push_back(std::llround(r.zz()*1.e9));
+
+    std::pair<std::map<Key,G4int>::iterator,G4bool> ins =
+      seen.insert(std::make_pair(Key(list[i].solid, values), G4int(i)));
+    if(!ins.second) list[i].duplicateOf = ins.first->second;
+  }
+}
+
+void GeometryValidator::CheckPlacement(const G4LogicalVolume* mother, const std::vector<Placement>& list,
+                                       size_t index, std::vector<Issue>& out) const
+{
+  const Placement& p = list[index];
+  const G4VSolid* motherSolid = mother->GetSolid();
+  const std::vector<G4ThreeVector>& points = fPoints.find(p.solid)->second;
+
+  // siblings whose extent meets this one; duplicates are already reported
+  std::vector<size_t> near;
+  for(size_t j=0; j<list.size(); j++){
+    if(j == index) continue;
+    const Placement& q = list[j];
+    if(p.duplicateOf == G4int(j) || q.duplicateOf == G4int(index) ||
+       (p.duplicateOf >= 0 && p.duplicateOf == q.duplicateOf)) continue;
+    G4bool apart = false;
+    for(G4int a=0; a<3 && !apart; a++)
+      apart = q.lo[a] > p.hi[a] + fTolerance || q.hi[a] < p.lo[a] - fTolerance;
+    if(!apart) near.push_back(j);
+  }
+
+  G4double protrusion = fTolerance;
+  G4ThreeVector protrusionPoint;
+  std::vector<G4double> depth(near.size(), fTolerance);
+  std::vector<G4ThreeVector> where(near.size());
+
+  for(size_t k=0; k<points.size(); k++){
+    G4ThreeVector pm = p.toMother.TransformPoint(points[k]);
+    if(motherSolid->Inside(pm) == kOutside){
+      G4double d = motherSolid->DistanceToIn(pm);
+      if(d > protrusion){ protrusion = d; protrusionPoint = pm; }
+    }
+    for(size_t n=0; n<near.size(); n++){
+      const Placement& q = list[near[n]];
+      G4bool outside = false;
+      for(G4int a=0; a<3 && !outside; a++) outside = pm[a] < q.lo[a] || pm[a] > q.hi[a];
+      if(outside) continue;
+      G4ThreeVector pq = q.fromMother.TransformPoint(pm);
+      if(q.solid->Inside(pq) != kInside) continue;
+      G4double d = q.solid->DistanceToOut(pq);
+      if(d > depth[n]){ depth[n] = d; where[n] = pm; }
+    }
+  }
+
+  Issue issue;
+  issue.volume = *p.name;
+  issue.copy = p.copy;
+  issue.mother = mother->GetName();
+  if(protrusion > fTolerance){
+    issue.kind = "protrusion";
+    issue.otherCopy = -1;
+    issue.depth = protrusion;
+    issue.point = protrusionPoint;
+    out.push_back(issue);
+  }
+  for(size_t n=0; n<near.size(); n++){
+    if(depth[n] <= fTolerance) continue;
+    issue.kind = "overlap";
+    issue.other = *list[near[n]].name;
+    issue.otherCopy = list[near[n]].copy;
+    issue.depth = depth[n];
+    issue.point = where[n];
+    out.push_back(issue);
+  }
+}
+
+G4int GeometryValidator::Validate(const G4VPhysicalVolume* world)
+{
+  fIssues.clear();
+  fNPlacements = 0;
+
+  // placements of every logical volume with daughters, each volume once
+  std::vector<const G4LogicalVolume*> mothers;
+  std::vector<std::vector<Placement> > lists;
+  std::set<const G4LogicalVolume*> visited;
+  std::vector<const G4LogicalVolume*> pending(1, world->GetLogicalVolume());
+  while(!pending.empty()){
+    const G4LogicalVolume* mother = pending.back();
+    pending.pop_back();
+    if(!visited.insert(mother).second || mother->GetNoDaughters() == 0) continue;
+
+    std::vector<Placement> list;
+    CollectPlacements(mother, list);
+    FindDuplicates(list);
+    for(size_t i=0; i<list.size(); i++){
+      if(list[i].duplicateOf < 0) continue;
+      Issue issue;
+      issue.kind = "duplicate";
+      issue.volume = *list[i].name;
+      issue.copy = list[i].copy;
+      issue.mother = mother->GetName();
+      issue.other = *list[list[i].duplicateOf].name;
+      issue.otherCopy = list[list[i].duplicateOf].copy;
+      issue.depth = 0.;
+      issue.point = list[i].toMother.NetTranslation();
+      fIssues.push_back(issue);
+    }
+    fNPlacements += list.size();
+    mothers.push_back(mother);
+    lists.push_back(list);
+
+    for(G4int i=0; i<mother->GetNoDaughters(); i++)
+      pending.push_back(mother->GetDaughter(i)->GetLogicalVolume());
+  }
+
+  // the point tests, one placement per job
+  std::vector<std::pair<size_t,size_t> > jobs;  // (mother, placement)
+  for(size_t m=0; m<lists.size(); m++)
+    for(size_t i=0; i<lists[m].size(); i++) jobs.push_back(std::make_pair(m,i));
+
+  std::vector<std::vector<Issue> > found(jobs.size());
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for(G4int t=0; t<fNThreads; t++){
+    workers.push_back(std::thread([&](){
+      for(size_t j = next++; j < jobs.size(); j = next++)
+        CheckPlacement(mothers[jobs[j].first], lists[jobs[j].first], jobs[j].second, found[j]);
+    }));
+  }
+  for(size_t t=0; t<workers.size(); t++) workers[t].join();
+
+  for(size_t j=0; j<found.size(); j++) fIssues.insert(fIssues.end(), found[j].begin(), found[j].end());
+
+  G4cout << "GeometryValidator: " << fNPlacements << " placements checked with "
+         << fResolution << " points on " << fNThreads << " threads, "
+         << fIssues.size() << " issues" << G4endl;
+  for(size_t i=0; i<fIssues.size(); i++){
+    const Issue& issue = fIssues[i];
+    G4cout << "  " << issue.kind << ": " << issue.volume << " [" << issue.copy << "] in "
+           << issue.mother;
+    if(issue.kind != "protrusion") G4cout << " with " << issue.other << " [" << issue.otherCopy << "]";
+    if(issue.depth > 0.) G4cout << " by " << issue.depth/mm << " mm";
+    G4cout << " at " << issue.point/mm << " mm" << G4endl;
+  }
+  return fIssues.size();
+}
+
+G4bool GeometryValidator::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out){
+    G4cerr << "GeometryValidator: cannot write " << fileName << G4endl;
+    return false;
+  }
+  out << "kind,volume,copy,mother,other,other_copy,depth_mm,x_mm,y_mm,z_mm\n";
+  for(size_t i=0; i<fIssues.size(); i++){
+    const Issue& issue = fIssues[i];
+    out << issue.kind << ',' << issue.volume << ',' << issue.copy << ',' << issue.mother << ','
+        << issue.other << ',' << issue.otherCopy << ',' << issue.depth/mm << ','
+        << issue.point.x()/mm << ',' << issue.point.y()/mm << ',' << issue.point.z()/mm << '\n';
+  }
+  return true;
+}
@@ -0,0 +1,88 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "NavigationStats.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelProxy.hh"
+#include "G4SmartVoxelNode.hh"
+
+#include <set>
+#include <algorithm>
+
+namespace {
+  struct VoxelCount {
+    G4int slices, maxDepth, contained, maxContained;
+    std::set<const G4SmartVoxelHeader*> headers;
+    std::set<const G4SmartVoxelNode*>   nodes;
+  };
+
+  // equal neighbouring slices share one proxy, so headers and nodes are
+  // counted once
+  void Walk(const G4SmartVoxelHeader* header, G4int depth, VoxelCount& count)
+  {
+    if(!count.headers.insert(header).second) return;
+    count.maxDepth = std::max(count.maxDepth, depth);
+    for(size_t i=0; i<header->GetNoSlices(); i++){
+      G4SmartVoxelProxy* proxy = header->GetSlice(i);
+      count.slices++;
+      if(proxy->IsHeader()){
+        Walk(proxy->GetHeader(), depth+1, count);
+      }else if(count.nodes.insert(proxy->GetNode()).second){
+        G4int n = proxy->GetNode()->GetNoContained();
+        count.contained += n;
+        count.maxContained = std::max(count.maxContained, n);
+      }
+    }
+  }
+
+  const char* AxisName(EAxis axis)
+  {
+    switch(axis){
+      case kXAxis: return "x";
+      case kYAxis: return "y";
+      case kZAxis: return "z";
+      default:     return "non-cartesian";
+    }
+  }
+}
+
+void NavigationStats::PrintVoxels(const G4LogicalVolume* lv)
+{
+  const G4SmartVoxelHeader* header = lv->GetVoxelHeader();
+  G4cout << "Voxels of " << lv->GetName() << ": " << lv->GetNoDaughters()
+         << " daughters, smartless " << lv->GetSmartless();
+  if(!header){
+    G4cout << ", not voxelised (geometry open, optimisation off or too few daughters)" << G4endl;
+    return;
+  }
+  VoxelCount count = {0, 0, 0, 0};
+  Walk(header, 1, count);
+  G4cout << ", top axis " << AxisName(header->GetAxis())
+         << " (" << header->GetNoSlices() << " slices)" << G4endl
+         << "  " << count.headers.size() << " headers, " << count.slices << " slices, "
+         << count.nodes.size() << " nodes, depth " << count.maxDepth << G4endl
+         << "  daughters per node: mean "
+         << (count.nodes.empty() ? 0. : G4double(count.contained)/count.nodes.size())
+         << ", max " << count.maxContained << G4endl;
+}
+
+G4int NavigationStats::Candidates(const G4LogicalVolume* lv, const G4ThreeVector& p)
+{
+  const G4SmartVoxelHeader* header = lv->GetVoxelHeader();
+  while(header){
+    EAxis axis = header->GetAxis();
+    if(axis != kXAxis && axis != kYAxis && axis != kZAxis) break;
+    G4double width = (header->GetMaxExtent() - header->GetMinExtent())/header->GetNoSlices();
+    G4int slice = G4int((p[axis] - header->GetMinExtent())/width);
+    slice = std::max(0, std::min(slice, G4int(header->GetNoSlices())-1));
+    G4SmartVoxelProxy* proxy = header->GetSlice(slice);
+    if(proxy->IsNode()) return proxy->GetNode()->GetNoContained();
+    header = proxy->GetHeader();
+  }
+  return lv->GetNoDaughters();
+}
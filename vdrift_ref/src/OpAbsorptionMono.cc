@@ -0,0 +1,27 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "OpAbsorptionMono.hh"
+#include "OpticalConstants.hh"
+
+#include "G4Track.hh"
+
+OpAbsorptionMono::OpAbsorptionMono(OpticalConstants* constants, const G4String& processName)
+:G4OpAbsorption(processName),fConstants(constants)
+{}
+
+OpAbsorptionMono::~OpAbsorptionMono()
+{}
+
+G4double OpAbsorptionMono::GetMeanFreePath(const G4Track& aTrack, G4double previousStepSize,
+                                           G4ForceCondition* condition)
+{
+  if(!fConstants->IsLine(aTrack.GetDynamicParticle()->GetTotalMomentum()))
+    return G4OpAbsorption::GetMeanFreePath(aTrack, previousStepSize, condition);
+
+  *condition = NotForced;
+  return fConstants->Get(aTrack.GetMaterial()).absLength;
+}
@@ -0,0 +1,34 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "OpRayleighMono.hh"
+#include "OpticalConstants.hh"
+
+#include "G4Track.hh"
+
+OpRayleighMono::OpRayleighMono(OpticalConstants* constants, const G4String& processName)
+:G4OpRayleigh(processName),fConstants(constants)
+{}
+
+OpRayleighMono::~OpRayleighMono()
+{}
+
+void OpRayleighMono::BuildPhysicsTable(const G4ParticleDefinition& particle)
+{
+  G4OpRayleigh::BuildPhysicsTable(particle);
+  // materials are final by now
+  fConstants->Resolve();
+}
+
+G4double OpRayleighMono::GetMeanFreePath(const G4Track& aTrack, G4double previousStepSize,
+                                         G4ForceCondition* condition)
+{
+  if(!fConstants->IsLine(aTrack.GetDynamicParticle()->GetTotalMomentum()))
+    return G4OpRayleigh::GetMeanFreePath(aTrack, previousStepSize, condition);
+
+  *condition = NotForced;
+  return fConstants->Get(aTrack.GetMaterial()).rayleighLength;
+}
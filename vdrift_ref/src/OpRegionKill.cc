@@ -0,0 +1,54 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "OpRegionKill.hh"
+
+#include "G4OpticalPhoton.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Track.hh"
+
+G4bool OpRegionKill::fActive = false;
+
+OpRegionKill::OpRegionKill(const G4String& processName)
+ : G4VDiscreteProcess(processName, fGeneral)
+{}
+
+OpRegionKill::~OpRegionKill()
+{}
+
+G4bool OpRegionKill::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return (&particle == G4OpticalPhoton::OpticalPhotonDefinition());
+}
+
+G4bool OpRegionKill::IsOutside(const G4LogicalVolume* volume)
+{
+  // the regions outlive geometry rebuilds, so they are looked up once
+  static G4ThreadLocal const G4Region* world = 0;
+  static G4ThreadLocal const G4Region* outer = 0;
+  if(!world) world = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+  if(!outer) outer = G4RegionStore::GetInstance()->GetRegion("Outer", false);
+  const G4Region* region = volume->GetRegion();
+  return region && (region == world || region == outer);
+}
+
+G4double OpRegionKill::PostStepGetPhysicalInteractionLength(const G4Track& aTrack,
+                                                            G4double,
+                                                            G4ForceCondition* condition)
+{
+  *condition = NotForced;
+  if(fActive && IsOutside(aTrack.GetVolume()->GetLogicalVolume())) return 0.;
+  return DBL_MAX;
+}
+
+G4VParticleChange* OpRegionKill::PostStepDoIt(const G4Track& aTrack, const G4Step&)
+{
+  aParticleChange.Initialize(aTrack);
+  aParticleChange.ProposeTrackStatus(fStopAndKill);
+  return &aParticleChange;
+}
@@ -0,0 +1,76 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "OpticalConstants.hh"
+
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cfloat>
+
+OpticalConstants::OpticalConstants()
+:fActive(true),fEnergy(0.)
+{}
+
+OpticalConstants::~OpticalConstants()
+{}
+
+void OpticalConstants::Resolve()
+{
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+
+  // common single-line emission spectrum, if any
+  fEnergy = 0.;
+  G4bool single = true;
+  const char* components[2] = {"FASTCOMPONENT", "SLOWCOMPONENT"};
+  for(size_t i=0; i<materials->size(); i++){
+    G4MaterialPropertiesTable* mpt = (*materials)[i]->GetMaterialPropertiesTable();
+    if(!mpt) continue;
+    for(G4int c=0; c<2; c++){
+      G4MaterialPropertyVector* spectrum = mpt->GetProperty(components[c]);
+      if(!spectrum) continue;
+      G4double e = spectrum->Energy(0);
+      if(spectrum->GetVectorLength() != 1 || (fEnergy > 0. && e != fEnergy)) single = false;
+      fEnergy = e;
+    }
+  }
+  if(!single) fEnergy = 0.;
+
+  fConstants.assign(materials->size(), MaterialOpticalConstants());
+  for(size_t i=0; i<materials->size(); i++){
+    MaterialOpticalConstants& c = fConstants[i];
+    c.valid = false;
+    c.rindex = 1.;
+    c.absLength = DBL_MAX;
+    c.rayleighLength = DBL_MAX;
+    c.groupVelocity = c_light;
+
+    G4MaterialPropertiesTable* mpt = (*materials)[i]->GetMaterialPropertiesTable();
+    if(!mpt || fEnergy <= 0.) continue;
+
+    c.valid = true;
+    G4MaterialPropertyVector* v = mpt->GetProperty("RINDEX");
+    if(v) c.rindex = v->Value(fEnergy);
+    v = mpt->GetProperty("ABSLENGTH");
+    if(v) c.absLength = v->Value(fEnergy);
+    v = mpt->GetProperty("RAYLEIGH");
+    if(v) c.rayleighLength = v->Value(fEnergy);
+    v = mpt->GetProperty("GROUPVEL");
+    c.groupVelocity = v ? v->Value(fEnergy) : c_light/c.rindex;
+  }
+
+  if(fEnergy > 0.)
+    G4cout << "OpticalConstants: monochromatic optical transport at "
+           << fEnergy/eV << " eV" << G4endl;
+}
+
+const MaterialOpticalConstants& OpticalConstants::Get(const G4Material* material)
+{
+  if(material->GetIndex() >= fConstants.size()) Resolve();
+  return fConstants[material->GetIndex()];
+}
@@ -0,0 +1,115 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhotonCulling.hh"
+#include "PhotonCullingMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4Material.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4OpticalSurface.hh"
+#include "Randomize.hh"
+
+#include <cfloat>
+#include <cmath>
+
+PhotonCulling::PhotonCulling(DetectorConstruction* det)
+:fDetector(det),fMessenger(0),
+ fActive(false),fThreshold(0.1),fRoulette(false),fSurvival(0.1),
+ fInitialised(false),fAbsLength(0),fAnodeReflectivity(0),fCryostatReflectivity(0)
+{
+  fMessenger = new PhotonCullingMessenger(this);
+}
+
+PhotonCulling::~PhotonCulling() { delete fMessenger; }
+
+void PhotonCulling::Initialise()
+{
+  fInitialised = true;
+
+  G4Material* lAr = G4Material::GetMaterial("G4_lAr");
+  if(lAr && lAr->GetMaterialPropertiesTable())
+    fAbsLength = lAr->GetMaterialPropertiesTable()->GetProperty("ABSLENGTH");
+
+  const G4LogicalSkinSurfaceTable* skins = G4LogicalSkinSurface::GetSurfaceTable();
+  for(size_t i=0; i<skins->size(); i++){
+    G4OpticalSurface* surf =
+      dynamic_cast<G4OpticalSurface*>((*skins)[i]->GetSurfaceProperty());
+    if(!surf || !surf->GetMaterialPropertiesTable()) continue;
+    G4MaterialPropertyVector* r =
+      surf->GetMaterialPropertiesTable()->GetProperty("REFLECTIVITY");
+    if(surf->GetName() == "AnodeSurface") fAnodeReflectivity = r;
+    if(surf->GetName() == "CryostatSurface") fCryostatReflectivity = r;
+  }
+}
+
+G4double PhotonCulling::Survival(const G4ThreeVector& pos, const G4ThreeVector& dir,
+                                 G4double energy)
+{
+  if(!fInitialised) Initialise();
+
+  // first face of the active box along the ray
+  G4ThreeVector half = fDetector->GetActiveHalfSize();
+  G4double tExit = DBL_MAX;
+  G4int face = -1;
+  for(G4int a=0; a<3; a++){
+    if(std::fabs(pos[a]) > half[a]) return -1.;
+    G4double t;
+    if(dir[a] > 0.)      t = (half[a]-pos[a])/dir[a];
+    else if(dir[a] < 0.) t = (-half[a]-pos[a])/dir[a];
+    else continue;
+    if(t < tExit){ tExit = t; face = 2*a + (dir[a] > 0. ? 1 : 0); }
+  }
+  if(face < 0) return -1.;
+  // periodic ends are not walls, the photon goes on in the next period
+  if(face/2 == 2 && fDetector->IsPeriodic()) return -1.;
+
+  // any window plane crossed on the way
+  const std::vector<DetectorConstruction::WindowPlane>& planes = fDetector->GetWindowPlanes();
+  for(size_t k=0; k<planes.size(); k++){
+    const DetectorConstruction::WindowPlane& plane = planes[k];
+    G4double d = dir[plane.axis];
+    if(d == 0.) continue;
+    G4double t = (plane.pos-pos[plane.axis])/d;
+    if(t <= 0. || t >= tExit) continue;
+    G4ThreeVector hit = pos + t*dir;
+    G4bool inside = true;
+    for(G4int a=0; a<3; a++){
+      if(a == plane.axis) continue;
+      if(hit[a] < plane.lo[a] || hit[a] > plane.hi[a]) inside = false;
+    }
+    if(inside) return -1.;
+  }
+
+  // anode on +y, everything else behaves as the cryostat skin
+  G4MaterialPropertyVector* r = (face == 3) ? fAnodeReflectivity : fCryostatReflectivity;
+  G4double reflectivity = r ? r->Value(energy) : 1.;
+  G4double absLength = fAbsLength ? fAbsLength->Value(energy) : DBL_MAX;
+  return std::exp(-tExit/absLength)*reflectivity;
+}
+
+G4bool PhotonCulling::Apply(G4Track* track)
+{
+  if(!fActive) return false;
+
+  G4double survival = Survival(track->GetPosition(), track->GetMomentumDirection(),
+                               track->GetTotalEnergy());
+  if(survival < 0. || survival >= fThreshold) return false;
+
+  B1Run* run = static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  G4double weight = track->GetWeight();
+  if(!fRoulette || G4UniformRand() >= fSurvival){
+    track->SetTrackStatus(fStopAndKill);
+    run->AddCulled(weight);
+    return true;
+  }
+  track->SetWeight(weight/fSurvival);
+  run->AddCullingWeight(weight/fSurvival-weight);
+  return false;
+}
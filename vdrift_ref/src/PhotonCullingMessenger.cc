@@ -0,0 +1,65 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhotonCullingMessenger.hh"
+
+#include "PhotonCulling.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+
+PhotonCullingMessenger::PhotonCullingMessenger(PhotonCulling* culling)
+:G4UImessenger(),fCulling(culling),
+ fCullingDir(0),fActiveCmd(0),fThresholdCmd(0),fRouletteCmd(0),fSurvivalCmd(0)
+{
+  fCullingDir = new G4UIdirectory("/testem/culling/");
+  fCullingDir->SetGuidance("Reachability culling of optical photons");
+
+  fActiveCmd = new G4UIcmdWithABool("/testem/culling/active",this);
+  fActiveCmd->SetGuidance("Switch the culling at birth and after reflections on/off");
+  fActiveCmd->SetParameterName("flag",true);
+  fActiveCmd->SetDefaultValue(true);
+
+  fThresholdCmd = new G4UIcmdWithADouble("/testem/culling/threshold",this);
+  fThresholdCmd->SetGuidance("Cull photons that cannot see a window and whose");
+  fThresholdCmd->SetGuidance("survival to the next surface is below this value");
+  fThresholdCmd->SetParameterName("prob",false);
+  fThresholdCmd->SetRange("prob>=0. && prob<=1.");
+
+  fRouletteCmd = new G4UIcmdWithABool("/testem/culling/roulette",this);
+  fRouletteCmd->SetGuidance("Play culled photons at roulette instead of killing them");
+  fRouletteCmd->SetParameterName("flag",true);
+  fRouletteCmd->SetDefaultValue(true);
+
+  fSurvivalCmd = new G4UIcmdWithADouble("/testem/culling/survival",this);
+  fSurvivalCmd->SetGuidance("Roulette survival probability s; survivors get weight 1/s");
+  fSurvivalCmd->SetParameterName("s",false);
+  fSurvivalCmd->SetRange("s>0. && s<=1.");
+}
+
+PhotonCullingMessenger::~PhotonCullingMessenger()
+{
+  delete fActiveCmd;
+  delete fThresholdCmd;
+  delete fRouletteCmd;
+  delete fSurvivalCmd;
+  delete fCullingDir;
+}
+
+void PhotonCullingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fActiveCmd)
+    { fCulling->SetActive(fActiveCmd->GetNewBoolValue(newValue));}
+
+  if (command == fThresholdCmd)
+    { fCulling->SetThreshold(fThresholdCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fRouletteCmd)
+    { fCulling->SetRoulette(fRouletteCmd->GetNewBoolValue(newValue));}
+
+  if (command == fSurvivalCmd)
+    { fCulling->SetSurvival(fSurvivalCmd->GetNewDoubleValue(newValue));}
+}
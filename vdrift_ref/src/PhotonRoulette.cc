@@ -0,0 +1,57 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhotonRoulette.hh"
+#include "PhotonRouletteMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+PhotonRoulette::PhotonRoulette(DetectorConstruction* det)
+:fDetector(det),fMessenger(0),
+ fActive(false),fKillProbability(0.5),fMinReflections(3),
+ fMinPathLength(0.),fMinWindowDistance(1.*m)
+{
+  fMessenger = new PhotonRouletteMessenger(this);
+}
+
+PhotonRoulette::~PhotonRoulette() { delete fMessenger; }
+
+G4double PhotonRoulette::DistanceToWindowPlane(const G4Track* track) const
+{
+  const G4ThreeVector& pos = track->GetPosition();
+  G4double dx = std::fabs(fDetector->GetLatWindowX() - std::fabs(pos.x()));
+  G4double dy = std::fabs(pos.y() - fDetector->GetBotWindowY());
+  G4double dz = std::fabs(fDetector->GetShortWindowZ() - std::fabs(pos.z()));
+  return std::min(dx, std::min(dy, dz));
+}
+
+G4bool PhotonRoulette::Apply(G4Track* track, G4int nReflections)
+{
+  if(!fActive || fKillProbability <= 0.) return false;
+  if(nReflections < fMinReflections) return false;
+  if(track->GetTrackLength() < fMinPathLength) return false;
+  if(DistanceToWindowPlane(track) < fMinWindowDistance) return false;
+
+  B1Run* run = static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  G4double weight = track->GetWeight();
+  if(G4UniformRand() < fKillProbability){
+    track->SetTrackStatus(fStopAndKill);
+    run->AddRouletteKill(weight);
+    return true;
+  }
+  G4double newWeight = weight/(1.-fKillProbability);
+  track->SetWeight(newWeight);
+  run->AddRouletteWeight(newWeight-weight);
+  return false;
+}
@@ -0,0 +1,78 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhotonRouletteMessenger.hh"
+
+#include "PhotonRoulette.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+PhotonRouletteMessenger::PhotonRouletteMessenger(PhotonRoulette* roulette)
+:G4UImessenger(),fRoulette(roulette),
+ fRouletteDir(0),fActiveCmd(0),fKillProbCmd(0),fMinReflCmd(0),
+ fMinPathCmd(0),fMinDistCmd(0)
+{
+  fRouletteDir = new G4UIdirectory("/testem/roulette/");
+  fRouletteDir->SetGuidance("Russian roulette of optical photons");
+
+  fActiveCmd = new G4UIcmdWithABool("/testem/roulette/active",this);
+  fActiveCmd->SetGuidance("Switch the optical photon roulette on/off");
+  fActiveCmd->SetParameterName("flag",true);
+  fActiveCmd->SetDefaultValue(true);
+
+  fKillProbCmd = new G4UIcmdWithADouble("/testem/roulette/killProbability",this);
+  fKillProbCmd->SetGuidance("Kill probability p; survivors get weight 1/(1-p)");
+  fKillProbCmd->SetParameterName("p",false);
+  fKillProbCmd->SetRange("p>=0. && p<1.");
+
+  fMinReflCmd = new G4UIcmdWithAnInteger("/testem/roulette/minReflections",this);
+  fMinReflCmd->SetGuidance("Number of reflections before the roulette applies");
+  fMinReflCmd->SetParameterName("n",false);
+  fMinReflCmd->SetRange("n>=0");
+
+  fMinPathCmd = new G4UIcmdWithADoubleAndUnit("/testem/roulette/minPathLength",this);
+  fMinPathCmd->SetGuidance("Path length before the roulette applies");
+  fMinPathCmd->SetParameterName("length",false);
+  fMinPathCmd->SetRange("length>=0.");
+  fMinPathCmd->SetUnitCategory("Length");
+
+  fMinDistCmd = new G4UIcmdWithADoubleAndUnit("/testem/roulette/minWindowDistance",this);
+  fMinDistCmd->SetGuidance("Only photons further than this from every window plane are played");
+  fMinDistCmd->SetParameterName("dist",false);
+  fMinDistCmd->SetRange("dist>=0.");
+  fMinDistCmd->SetUnitCategory("Length");
+}
+
+PhotonRouletteMessenger::~PhotonRouletteMessenger()
+{
+  delete fActiveCmd;
+  delete fKillProbCmd;
+  delete fMinReflCmd;
+  delete fMinPathCmd;
+  delete fMinDistCmd;
+  delete fRouletteDir;
+}
+
+void PhotonRouletteMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fActiveCmd)
+    { fRoulette->SetActive(fActiveCmd->GetNewBoolValue(newValue));}
+
+  if (command == fKillProbCmd)
+    { fRoulette->SetKillProbability(fKillProbCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fMinReflCmd)
+    { fRoulette->SetMinReflections(fMinReflCmd->GetNewIntValue(newValue));}
+
+  if (command == fMinPathCmd)
+    { fRoulette->SetMinPathLength(fMinPathCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fMinDistCmd)
+    { fRoulette->SetMinWindowDistance(fMinDistCmd->GetNewDoubleValue(newValue));}
+}
@@ -1,5 +1,16 @@
 #include "globals.hh"
 #include "PhysicsList.hh"
+#include "PhysicsListMessenger.hh"
+#include "PhysicsTableCache.hh"
+#include "PhysListEmStandard.hh"
+#include "PhysListEmLivermore.hh"
+#include "PhysListEmPenelope.hh"
+
+#include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option3.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4EmPenelopePhysics.hh"
 
 #include "G4ParticleDefinition.hh"
 #include "G4ParticleTypes.hh"
@@ -16,22 +27,40 @@
 
 #include "G4Cerenkov.hh"
 #include "G4Scintillation.hh"
-#include "G4OpAbsorption.hh"
-#include "G4OpRayleigh.hh"
+#include "OpAbsorptionMono.hh"
+#include "FastOpRayleigh.hh"
+#include "OpticalConstants.hh"
 #include "G4OpMieHG.hh"
-#include "G4OpBoundaryProcess.hh"
+#include "FastOpBoundaryProcess.hh"
 #include "G4OpWLS.hh"
+#include "OpRegionKill.hh"
+#include "RegionRestricted.hh"
 
 #include "G4LossTableManager.hh"
 #include "G4EmSaturation.hh"
+#include "G4UserSpecialCuts.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+
+#include <sstream>
+
+G4ThreadLocal G4Scintillation* PhysicsList::fScintillationProcess = 0;
+G4ThreadLocal FastOpBoundaryProcess* PhysicsList::fBoundaryProcess = 0;
+G4ThreadLocal OpticalConstants* PhysicsList::fOpticalConstants = 0;
+G4ThreadLocal FastOpRayleigh* PhysicsList::fRayleighProcess = 0;
  
 PhysicsList::PhysicsList() 
- : G4VUserPhysicsList(),
-   fVerboseLebel(1), fMaxNumPhotonStep(20)
+ : G4VModularPhysicsList(),
+   fVerboseLebel(1), fMessenger(0), fEmName("local"), fEmPhysicsList(0), fMaxNumPhotonStep(20),
+   fOpticalYieldScale(1.), fFastBoundary(true), fMonochromatic(true),
+   fFastRayleigh(true), fCryostatOnly(false), fTableCache(0)
 {
+  fMessenger = new PhysicsListMessenger(this);
+  fTableCache = new PhysicsTableCache(this);
 }
 
-PhysicsList::~PhysicsList() { }
+PhysicsList::~PhysicsList() { delete fMessenger; delete fTableCache; delete fEmPhysicsList; }
 
 void PhysicsList::ConstructParticle()
 {
@@ -56,8 +85,64 @@ void PhysicsList::ConstructProcess()
 {
   AddTransportation();
   ConstructDecay();
-  ConstructEM();
+  if (fEmPhysicsList) fEmPhysicsList->ConstructProcess();
+  else ConstructEM();
+
+  // minimum energy of the Outer region (DetectorConstruction), whatever
+  // the EM constructor
+  G4ParticleDefinition* leptons[2] = {G4Electron::Electron(), G4Positron::Positron()};
+  for(G4int i=0; i<2; i++)
+    leptons[i]->GetProcessManager()->AddDiscreteProcess(new G4UserSpecialCuts());
+
   ConstructOp();
+  AddParameterisation();
+}
+
+void PhysicsList::AddPhysicsList(const G4String& name)
+{
+  if (verboseLevel>0)
+    G4cout << "PhysicsList::AddPhysicsList: <" << name << ">" << G4endl;
+  if (name == fEmName) return;
+
+  G4VPhysicsConstructor* em = 0;
+  if (name == "local") {
+    // ConstructEM
+  } else if (name == "standard") {
+    em = new PhysListEmStandard(name);
+  } else if (name == "livermore") {
+    em = new PhysListEmLivermore(name);
+  } else if (name == "penelope") {
+    em = new PhysListEmPenelope(name);
+  } else if (name == "emstandard_opt0") {
+    em = new G4EmStandardPhysics();
+  } else if (name == "emstandard_opt3") {
+    em = new G4EmStandardPhysics_option3();
+  } else if (name == "emstandard_opt4") {
+    em = new G4EmStandardPhysics_option4();
+  } else if (name == "emlivermore") {
+    em = new G4EmLivermorePhysics();
+  } else if (name == "empenelope") {
+    em = new G4EmPenelopePhysics();
+  } else {
+    G4cout << "PhysicsList::AddPhysicsList: <" << name << ">"
+           << " is not defined" << G4endl;
+    return;
+  }
+  delete fEmPhysicsList;
+  fEmPhysicsList = em;
+  fEmName = name;
+}
+
+#include "G4FastSimulationManagerProcess.hh"
+
+void PhysicsList::AddParameterisation()
+{
+  // lets EMShowerModel (DetectorConstruction::ConstructSDandField) take
+  // over e-, e+ and gammas in the LAr; nothing happens while it is off
+  G4FastSimulationManagerProcess* fastSimProcess = new G4FastSimulationManagerProcess("G4FSMP");
+  G4ParticleDefinition* particles[3] = {G4Electron::Electron(), G4Positron::Positron(), G4Gamma::Gamma()};
+  for(G4int i=0; i<3; i++)
+    particles[i]->GetProcessManager()->AddDiscreteProcess(fastSimProcess);
 }
 
 #include "G4Decay.hh"
@@ -151,21 +236,67 @@ void PhysicsList::ConstructEM()
 }
 
 #include "G4Threading.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+
+// true if a material of the geometry has the property; G4OpRayleigh also
+// computes the scattering of a material named Water without one
+static G4bool AnyMaterialHas(const char* property)
+{
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  for(size_t i=0; i<materials->size(); i++){
+    G4MaterialPropertiesTable* mpt = (*materials)[i]->GetMaterialPropertiesTable();
+    if(mpt && mpt->GetProperty(property)) return true;
+    if(G4String(property) == "RAYLEIGH" && (*materials)[i]->GetName() == "Water") return true;
+  }
+  return false;
+}
 
 void PhysicsList::ConstructOp()
 {
-  G4OpWLS* wlsProcess = new G4OpWLS();
-  G4Cerenkov* cerenkovProcess = new G4Cerenkov("Cerenkov");
+  // the photon processes no material has data for would only be queried
+  // for an infinite interaction length at every step; they are left out
+  // (the geometry, and so the materials, are built before the physics)
+  G4bool absorption = AnyMaterialHas("ABSLENGTH");
+  G4bool rayleigh = AnyMaterialHas("RAYLEIGH");
+  G4bool mie = AnyMaterialHas("MIEHG");
+  G4bool wls = AnyMaterialHas("WLSABSLENGTH");
+  if(!G4Threading::IsWorkerThread()){
+    G4String skipped;
+    if(!absorption) skipped += " OpAbsorption";
+    if(!rayleigh) skipped += " OpRayleigh";
+    if(!mie) skipped += " OpMieHG";
+    if(!wls) skipped += " OpWLS";
+    if(skipped != "")
+      G4cout << "PhysicsList: no material data for" << skipped << ", not registered" << G4endl;
+  }
+
+  G4OpWLS* wlsProcess = wls ? new G4OpWLS() : 0;
+  G4Cerenkov* cerenkovProcess = new RegionRestricted<G4Cerenkov>("Cerenkov");
   cerenkovProcess->SetMaxNumPhotonsPerStep(fMaxNumPhotonStep);
   cerenkovProcess->SetMaxBetaChangePerStep(10.0);
-  cerenkovProcess->SetTrackSecondariesFirst(true);
-  G4Scintillation* scintillationProcess = new G4Scintillation("Scintillation");
-  scintillationProcess->SetScintillationYieldFactor(1.);
-  scintillationProcess->SetTrackSecondariesFirst(true);
-  G4OpAbsorption* absorptionProcess = new G4OpAbsorption();
-  G4OpRayleigh* rayleighScatteringProcess = new G4OpRayleigh();
-  G4OpMieHG* mieHGScatteringProcess = new G4OpMieHG();
-  G4OpBoundaryProcess* boundaryProcess = new G4OpBoundaryProcess();
+  // photons are batched by StackingAction, no need to suspend the parent
+  cerenkovProcess->SetTrackSecondariesFirst(false);
+  G4Scintillation* scintillationProcess = new RegionRestricted<G4Scintillation>("Scintillation");
+  scintillationProcess->SetScintillationYieldFactor(fOpticalYieldScale);
+  scintillationProcess->SetTrackSecondariesFirst(false);
+  fScintillationProcess = scintillationProcess;
+  fOpticalConstants = new OpticalConstants();
+  fOpticalConstants->SetActive(fMonochromatic);
+  OpAbsorptionMono* absorptionProcess = absorption ? new OpAbsorptionMono(fOpticalConstants) : 0;
+  FastOpRayleigh* rayleighScatteringProcess = 0;
+  if(rayleigh){
+    rayleighScatteringProcess = new FastOpRayleigh(fOpticalConstants);
+    rayleighScatteringProcess->SetFastSampling(fFastRayleigh);
+  }
+  fRayleighProcess = rayleighScatteringProcess;
+  G4OpMieHG* mieHGScatteringProcess = mie ? new G4OpMieHG() : 0;
+  FastOpBoundaryProcess* boundaryProcess = new FastOpBoundaryProcess();
+  boundaryProcess->SetFastPath(fFastBoundary);
+  boundaryProcess->SetOpticalConstants(fOpticalConstants);
+  fBoundaryProcess = boundaryProcess;
+  OpRegionKill* regionKillProcess = new OpRegionKill();
+  OpRegionKill::SetActive(fCryostatOnly);
   
   if(!G4Threading::IsWorkerThread())
   {
@@ -191,11 +322,12 @@ void PhysicsList::ConstructOp()
     }
     if (particleName == "opticalphoton") {
       G4cout << " AddDiscreteProcess to OpticalPhoton " << G4endl;
-      pmanager->AddDiscreteProcess(absorptionProcess);
-      pmanager->AddDiscreteProcess(rayleighScatteringProcess);
-      pmanager->AddDiscreteProcess(mieHGScatteringProcess);
+      if(absorptionProcess) pmanager->AddDiscreteProcess(absorptionProcess);
+      if(rayleighScatteringProcess) pmanager->AddDiscreteProcess(rayleighScatteringProcess);
+      if(mieHGScatteringProcess) pmanager->AddDiscreteProcess(mieHGScatteringProcess);
       pmanager->AddDiscreteProcess(boundaryProcess);
-      pmanager->AddDiscreteProcess(wlsProcess);
+      if(wlsProcess) pmanager->AddDiscreteProcess(wlsProcess);
+      pmanager->AddDiscreteProcess(regionKillProcess);
     }
   }
 }
@@ -210,10 +342,84 @@ void PhysicsList::SetNbOfPhotonsCerenkov(G4int MaxNumber)
     fMaxNumPhotonStep = MaxNumber;
 }
 
+void PhysicsList::SetOpticalYieldScale(G4double scale)
+{
+  fOpticalYieldScale = scale;
+  // the process of this thread picks the new value up directly, those of
+  // the workers at the next run (ApplyOpticalSettings); the Cerenkov part
+  // is thinned at tracking time
+  if(fScintillationProcess)
+    fScintillationProcess->SetScintillationYieldFactor(fOpticalYieldScale);
+}
+
+G4double PhysicsList::GetScintillationYieldFactor() const
+{
+  return fScintillationProcess ? fScintillationProcess->GetScintillationYieldFactor()
+                               : fOpticalYieldScale;
+}
+
+void PhysicsList::ApplyOpticalSettings()
+{
+  if(fScintillationProcess)
+    fScintillationProcess->SetScintillationYieldFactor(fOpticalYieldScale);
+  if(fBoundaryProcess) fBoundaryProcess->SetFastPath(fFastBoundary);
+  if(fOpticalConstants) fOpticalConstants->SetActive(fMonochromatic);
+  if(fRayleighProcess) fRayleighProcess->SetFastSampling(fFastRayleigh);
+}
+
+void PhysicsList::SetFastBoundary(G4bool val)
+{
+  fFastBoundary = val;
+  if(fBoundaryProcess) fBoundaryProcess->SetFastPath(fFastBoundary);
+}
+
+void PhysicsList::SetMonochromatic(G4bool val)
+{
+  fMonochromatic = val;
+  if(fOpticalConstants) fOpticalConstants->SetActive(fMonochromatic);
+}
+
+void PhysicsList::SetFastRayleigh(G4bool val)
+{
+  fFastRayleigh = val;
+  if(fRayleighProcess) fRayleighProcess->SetFastSampling(fFastRayleigh);
+}
+
+void PhysicsList::SetCryostatOnly(G4bool val)
+{
+  fCryostatOnly = val;
+  OpRegionKill::SetActive(fCryostatOnly);
+}
+
+void PhysicsList::SetPhysicsTableCache(const G4String& dir)
+{
+  fTableCache->SetDirectory(dir == "none" ? G4String("") : dir);
+}
+
+G4String PhysicsList::GetConfiguration() const
+{
+  std::ostringstream conf;
+  // the optical switches act at tracking time only and are left out
+  conf << "em=" << fEmName;
+  return conf.str();
+}
+
 void PhysicsList::SetCuts()
 {
   SetCutsWithDefault();
 
+  // the world outside the cryostat shell takes the cuts of the Outer
+  // region (DetectorConstruction::ConstructRegions)
+  G4Region* outer = G4RegionStore::GetInstance()->GetRegion("Outer", false);
+  if(outer && outer->GetProductionCuts()){
+    const char* particles[4] = {"gamma", "e-", "e+", "proton"};
+    for(G4int i=0; i<4; i++)
+      SetCutValue(outer->GetProductionCuts()->GetProductionCut(particles[i]), particles[i]);
+  }
+
+  // cuts and materials are final here
+  fTableCache->Prepare();
+
   if (verboseLevel>0) DumpCutValuesTable();
 }
 
@@ -0,0 +1,117 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhysicsListMessenger.hh"
+
+#include "PhysicsList.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
+:G4UImessenger(),fPhysicsList(pPhys),
+ fPhysDir(0),fYieldScaleCmd(0),fFastBoundaryCmd(0),fMonoCmd(0),
+ fFastRayleighCmd(0),fCryostatOnlyCmd(0),fTableCacheCmd(0),fListCmd(0)
+{
+  fPhysDir = new G4UIdirectory("/testem/phys/");
+  fPhysDir->SetGuidance("physics list commands");
+
+  fYieldScaleCmd = new G4UIcmdWithADouble("/testem/phys/opticalYieldScale",this);
+  fYieldScaleCmd->SetGuidance("Scale scintillation and Cerenkov photon yield by f.");
+  fYieldScaleCmd->SetGuidance("Surviving photons are tracked with weight 1/f.");
+  fYieldScaleCmd->SetParameterName("f",false);
+  fYieldScaleCmd->SetRange("f>0. && f<=1.");
+  fYieldScaleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fYieldScaleCmd->SetToBeBroadcasted(false);
+
+  fFastBoundaryCmd = new G4UIcmdWithABool("/testem/phys/fastBoundary",this);
+  fFastBoundaryCmd->SetGuidance("Handle Lambertian dielectric_metal skins without");
+  fFastBoundaryCmd->SetGuidance("the general G4OpBoundaryProcess path.");
+  fFastBoundaryCmd->SetParameterName("flag",true);
+  fFastBoundaryCmd->SetDefaultValue(true);
+  fFastBoundaryCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFastBoundaryCmd->SetToBeBroadcasted(false);
+
+  fMonoCmd = new G4UIcmdWithABool("/testem/phys/monochromatic",this);
+  fMonoCmd->SetGuidance("Use optical constants resolved at the scintillation line");
+  fMonoCmd->SetGuidance("for photons at that energy (Cerenkov keeps the general path).");
+  fMonoCmd->SetParameterName("flag",true);
+  fMonoCmd->SetDefaultValue(true);
+  fMonoCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fMonoCmd->SetToBeBroadcasted(false);
+
+  fFastRayleighCmd = new G4UIcmdWithABool("/testem/phys/fastRayleigh",this);
+  fFastRayleighCmd->SetGuidance("Sample Rayleigh scattering from a tabulated inverse CDF");
+  fFastRayleighCmd->SetGuidance("instead of the G4OpRayleigh accept/reject loop.");
+  fFastRayleighCmd->SetParameterName("flag",true);
+  fFastRayleighCmd->SetDefaultValue(true);
+  fFastRayleighCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFastRayleighCmd->SetToBeBroadcasted(false);
+
+  fCryostatOnlyCmd = new G4UIcmdWithABool("/testem/phys/opticalCryostatOnly",this);
+  fCryostatOnlyCmd->SetGuidance("Make and track optical photons only inside the cryostat:");
+  fCryostatOnlyCmd->SetGuidance("no scintillation or Cerenkov light in the shell and the world,");
+  fCryostatOnlyCmd->SetGuidance("photons reaching them are killed.");
+  fCryostatOnlyCmd->SetParameterName("flag",true);
+  fCryostatOnlyCmd->SetDefaultValue(true);
+  fCryostatOnlyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fCryostatOnlyCmd->SetToBeBroadcasted(false);
+
+  fTableCacheCmd = new G4UIcmdWithAString("/testem/phys/tableCache",this);
+  fTableCacheCmd->SetGuidance("Directory of stored physics tables, none to disable.");
+  fTableCacheCmd->SetGuidance("The tables are retrieved from tables_<key> if present (key:");
+  fTableCacheCmd->SetGuidance("hash of the physics options, cuts and materials), otherwise");
+  fTableCacheCmd->SetGuidance("stored there after the first run. Use g4workshop");
+  fTableCacheCmd->SetGuidance("--table-cache=dir to have it before /run/initialize.");
+  fTableCacheCmd->SetParameterName("dir",false);
+  fTableCacheCmd->AvailableForStates(G4State_PreInit);
+
+  fListCmd = new G4UIcmdWithAString("/testem/phys/addPhysics",this);
+  fListCmd->SetGuidance("Select the EM physics constructor. local is the list");
+  fListCmd->SetGuidance("of PhysicsList::ConstructEM. Use g4workshop --em=name");
+  fListCmd->SetGuidance("to have it before /run/initialize.");
+  fListCmd->SetParameterName("PList",false);
+  fListCmd->SetCandidates("local standard livermore penelope emstandard_opt0 "
+                          "emstandard_opt3 emstandard_opt4 emlivermore empenelope");
+  fListCmd->AvailableForStates(G4State_PreInit);
+}
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+  delete fYieldScaleCmd;
+  delete fFastBoundaryCmd;
+  delete fMonoCmd;
+  delete fFastRayleighCmd;
+  delete fCryostatOnlyCmd;
+  delete fTableCacheCmd;
+  delete fListCmd;
+  delete fPhysDir;
+}
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fYieldScaleCmd)
+    { fPhysicsList->SetOpticalYieldScale(fYieldScaleCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fFastBoundaryCmd)
+    { fPhysicsList->SetFastBoundary(fFastBoundaryCmd->GetNewBoolValue(newValue));}
+
+  if (command == fMonoCmd)
+    { fPhysicsList->SetMonochromatic(fMonoCmd->GetNewBoolValue(newValue));}
+
+  if (command == fFastRayleighCmd)
+    { fPhysicsList->SetFastRayleigh(fFastRayleighCmd->GetNewBoolValue(newValue));}
+
+  if (command == fCryostatOnlyCmd)
+    { fPhysicsList->SetCryostatOnly(fCryostatOnlyCmd->GetNewBoolValue(newValue));}
+
+  if (command == fTableCacheCmd)
+    { fPhysicsList->SetPhysicsTableCache(newValue);}
+
+  if (command == fListCmd)
+    { fPhysicsList->AddPhysicsList(newValue);}
+}
@@ -0,0 +1,126 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "PhysicsTableCache.hh"
+#include "PhysicsList.hh"
+
+#include "G4StateManager.hh"
+#include "G4Threading.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Version.hh"
+
+#include <sstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PhysicsTableCache::PhysicsTableCache(PhysicsList* physics)
+:G4VStateDependent(),fPhysics(physics),fStore(false)
+{}
+
+PhysicsTableCache::~PhysicsTableCache()
+{}
+
+G4String PhysicsTableCache::GetKey() const
+{
+  std::ostringstream par;
+  par.precision(17);
+  par << G4VERSION_NUMBER << ' ' << fPhysics->GetConfiguration();
+
+  const G4RegionStore* regions = G4RegionStore::GetInstance();
+  for(size_t i=0; i<regions->size(); i++){
+    G4ProductionCuts* cuts = (*regions)[i]->GetProductionCuts();
+    par << ' ' << (*regions)[i]->GetName();
+    const char* particles[4] = {"gamma", "e-", "e+", "proton"};
+    for(G4int k=0; k<4 && cuts; k++) par << ' ' << cuts->GetProductionCut(particles[k]);
+  }
+
+  // composition and the properties the optical tables are built from
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  const char* properties[7] = {"RINDEX", "ABSLENGTH", "RAYLEIGH", "MIEHG", "WLSABSLENGTH",
+                               "FASTCOMPONENT", "SLOWCOMPONENT"};
+  for(size_t i=0; i<materials->size(); i++){
+    const G4Material* material = (*materials)[i];
+    par << ' ' << material->GetName() << ' ' << material->GetDensity() << ' '
+        << material->GetState() << ' ' << material->GetTemperature() << ' '
+        << material->GetPressure();
+    for(size_t e=0; e<material->GetNumberOfElements(); e++)
+      par << ' ' << material->GetElement(e)->GetZ() << ' ' << material->GetElement(e)->GetN()
+          << ' ' << material->GetFractionVector()[e];
+    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    for(G4int k=0; k<7 && mpt; k++){
+      G4MaterialPropertyVector* v = mpt->GetProperty(properties[k]);
+      if(!v) continue;
+      par << ' ' << properties[k];
+      for(size_t j=0; j<v->GetVectorLength(); j++) par << ' ' << v->Energy(j) << ' ' << (*v)[j];
+    }
+  }
+
+  // FNV-1a, as DetectorConstruction::GetGeometryKey
+  const std::string text = par.str();
+  unsigned long long hash = 14695981039346656037ULL;
+  for(size_t i=0; i<text.size(); i++){
+    hash ^= (unsigned char)text[i];
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex;
+  key.width(16);
+  key.fill('0');
+  key << hash;
+  return key.str();
+}
+
+void PhysicsTableCache::Prepare()
+{
+  fStore = false;
+  if(fDirectory.empty() || G4Threading::IsWorkerThread()) return;
+
+  fEntry = fDirectory + "/tables_" + GetKey();
+  struct stat info;
+  if(stat(fEntry.c_str(), &info) == 0 && S_ISDIR(info.st_mode)){
+    G4cout << "PhysicsTableCache: retrieving physics tables from " << fEntry << G4endl;
+    fPhysics->SetPhysicsTableRetrieved(fEntry);
+  }else{
+    G4cout << "PhysicsTableCache: no tables in " << fEntry << ", they are built and stored" << G4endl;
+    fStore = true;
+  }
+}
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  // the tables are built by the time the first run closes the geometry
+  if(fStore && requestedState == G4State_GeomClosed &&
+     G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle){
+    fStore = false;
+    Store();
+  }
+  return true;
+}
+
+void PhysicsTableCache::Store()
+{
+  // written under another name and renamed, so that concurrent jobs never
+  // retrieve a partial entry
+  mkdir(fDirectory.c_str(), 0755);
+  std::ostringstream tmp;
+  tmp << fEntry << ".tmp" << getpid();
+  if(mkdir(tmp.str().c_str(), 0755) != 0 || !fPhysics->StorePhysicsTable(tmp.str())){
+    G4cerr << "PhysicsTableCache: cannot store the physics tables in " << tmp.str() << G4endl;
+    return;
+  }
+  if(std::rename(tmp.str().c_str(), fEntry.c_str()) != 0){
+    G4cout << "PhysicsTableCache: " << fEntry << " written meanwhile by another job, "
+           << tmp.str() << " left in place" << G4endl;
+    return;
+  }
+  G4cout << "PhysicsTableCache: physics tables stored in " << fEntry << G4endl;
+}
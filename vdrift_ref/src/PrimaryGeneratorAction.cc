@@ -138,15 +138,3 @@ G4ThreeVector PrimaryGeneratorAction::TransversePosition(G4ThreeVector d, double
 
 }
 
-
-void PrimaryGeneratorAction::DepthSampling(){
-
-
-  
-
-}
-
-void PrimaryGeneratorAction::GetEMShowerParameters(){
-
-  
-}
@@ -0,0 +1,83 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "RayleighSampler.hh"
+
+#include "G4PhysicalConstants.hh"
+#include <cmath>
+#include <algorithm>
+
+RayleighSampler::RayleighSampler(G4int nBins)
+:fNBins(nBins),fTable(nBins+2)
+{
+  // CDF (2 + 3u - u^3)/4 inverted in closed form
+  for(G4int i=0; i<=fNBins; i++){
+    G4double xi = G4double(i)/fNBins;
+    fTable[i] = 2.*std::cos((std::acos(1.-2.*xi) + 2.*twopi)/3.);
+  }
+  fTable[0] = -1.;
+  fTable[fNBins] = 1.;
+  fTable[fNBins+1] = 1.;  // lets xi == 1 interpolate without a branch
+}
+
+RayleighSampler::~RayleighSampler()
+{}
+
+G4double RayleighSampler::SampleCosine(G4double xi) const
+{
+  G4double x = xi*fNBins;
+  G4int i = G4int(x);
+  G4double f = x - i;
+  return fTable[i] + f*(fTable[i+1] - fTable[i]);
+}
+
+void RayleighSampler::Scatter(const G4ThreeVector& dir, const G4ThreeVector& pol,
+                              const G4double* rand, G4ThreeVector& newDir,
+                              G4ThreeVector& newPol) const
+{
+  // frame around the old polarisation
+  G4ThreeVector e1 = (dir - (dir*pol)*pol).unit();
+  G4ThreeVector e2 = pol.cross(e1);
+
+  G4double u = SampleCosine(rand[0]);
+  G4double s = std::sqrt(std::max(1.-u*u, 1.e-30));
+  G4double phi = twopi*rand[1];
+  newDir = u*pol + s*(std::cos(phi)*e1 + std::sin(phi)*e2);
+
+  // either sign of the normal component, as in G4OpRayleigh
+  G4double sign = 1. - 2.*(rand[2] < 0.5);
+  newPol = (sign/s)*(pol - u*newDir);
+}
+
+void RayleighSampler::ScatterBatch(G4int n, G4double* dx, G4double* dy, G4double* dz,
+                                   G4double* px, G4double* py, G4double* pz,
+                                   const G4double* rand) const
+{
+  for(G4int i=0; i<n; i++){
+    const G4double* r = rand + 3*i;
+    G4double ex = px[i], ey = py[i], ez = pz[i];
+
+    G4double kp = dx[i]*ex + dy[i]*ey + dz[i]*ez;
+    G4double ax = dx[i] - kp*ex, ay = dy[i] - kp*ey, az = dz[i] - kp*ez;
+    G4double inv = 1./std::sqrt(ax*ax + ay*ay + az*az);
+    ax *= inv; ay *= inv; az *= inv;
+    G4double bx = ey*az - ez*ay, by = ez*ax - ex*az, bz = ex*ay - ey*ax;
+
+    G4double u = SampleCosine(r[0]);
+    G4double s = std::sqrt(std::max(1.-u*u, 1.e-30));
+    G4double phi = twopi*r[1];
+    G4double c = s*std::cos(phi), t = s*std::sin(phi);
+    G4double kx = u*ex + c*ax + t*bx;
+    G4double ky = u*ey + c*ay + t*by;
+    G4double kz = u*ez + c*az + t*bz;
+
+    G4double w = (1. - 2.*(r[2] < 0.5))/s;
+    px[i] = w*(ex - u*kx);
+    py[i] = w*(ey - u*ky);
+    pz[i] = w*(ez - u*kz);
+    dx[i] = kx; dy[i] = ky; dz[i] = kz;
+  }
+}
@@ -5,7 +5,18 @@
 B1Run::B1Run()
 : G4Run(),
   fEdep(0.), 
-  fEdep2(0.)
+  fEdep2(0.),
+  fNDetected(0),
+  fDetWeight(0.),
+  fDetWeight2(0.),
+  fNRouletteKilled(0),
+  fRouletteKilledWeight(0.),
+  fRouletteAddedWeight(0.),
+  fNCulled(0),
+  fCulledWeight(0.),
+  fCullingAddedWeight(0.),
+  fNNavSteps(0),
+  fNavCandidates(0.)
 {} 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -20,6 +31,17 @@ void B1Run::Merge(const G4Run* run)
   const B1Run* localRun = static_cast<const B1Run*>(run);
   fEdep  += localRun->fEdep;
   fEdep2 += localRun->fEdep2;
+  fNDetected  += localRun->fNDetected;
+  fDetWeight  += localRun->fDetWeight;
+  fDetWeight2 += localRun->fDetWeight2;
+  fNRouletteKilled      += localRun->fNRouletteKilled;
+  fRouletteKilledWeight += localRun->fRouletteKilledWeight;
+  fRouletteAddedWeight  += localRun->fRouletteAddedWeight;
+  fNCulled              += localRun->fNCulled;
+  fCulledWeight         += localRun->fCulledWeight;
+  fCullingAddedWeight   += localRun->fCullingAddedWeight;
+  fNNavSteps            += localRun->fNNavSteps;
+  fNavCandidates        += localRun->fNavCandidates;
 
   G4Run::Merge(run); 
 } 
@@ -34,4 +56,49 @@ void B1Run::AddEdep (G4double edep)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void B1Run::AddDetection (G4double weight)
+{
+  fNDetected++;
+  fDetWeight  += weight;
+  fDetWeight2 += weight*weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B1Run::AddRouletteKill (G4double weight)
+{
+  fNRouletteKilled++;
+  fRouletteKilledWeight += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B1Run::AddRouletteWeight (G4double dweight)
+{
+  fRouletteAddedWeight += dweight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void B1Run::AddCulled (G4double weight)
+{
+  fNCulled++;
+  fCulledWeight += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B1Run::AddCullingWeight (G4double dweight)
+{
+  fCullingAddedWeight += dweight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B1Run::AddNavigationStep (G4int candidates)
+{
+  fNNavSteps++;
+  fNavCandidates += candidates;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -8,20 +8,35 @@
 #include "Randomize.hh"
 
 #include "RunAction.hh"
+#include "Run.hh"
+#include "RunActionMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
 #include "g4root.hh"
+#include "G4SystemOfUnits.hh"
+#include <cmath>
 
-RunAction::RunAction(DetectorConstruction* det) 
-:fDetector(det)
+RunAction::RunAction(DetectorConstruction* det, PhysicsList* phys) 
+:fDetector(det),fPhysics(phys),fRecordPhotons(false),fMessenger(0)
 {   
   fSaveRndm = 0;  
+  fMessenger = new RunActionMessenger(this);
 }
 
 RunAction::~RunAction()
 {
+  delete fMessenger;
+}
+
+G4Run* RunAction::GenerateRun()
+{
+  return new B1Run;
 }
 
 void RunAction::BeginOfRunAction(const G4Run*)
 {  
+  // settings changed since the physics of this thread was built
+  if(fPhysics) fPhysics->ApplyOpticalSettings();
   
   // Get/create analysis manager
   G4cout << "##### Create analysis manager " << "  " << this << G4endl;
@@ -56,6 +71,54 @@ void RunAction::BeginOfRunAction(const G4Run*)
   man->CreateNtupleDColumn("time");
   man->FinishNtuple();
 
+  // Create 2nd ntuple (id = 2): one row per photon reaching a window,
+  // with what is needed to reweight it offline (see reweight.C)
+  if(fRecordPhotons){
+    man->CreateNtuple("photons", "detected optical photons");
+    man->CreateNtupleIColumn("evt");
+    man->CreateNtupleIColumn("vol");
+    man->CreateNtupleDColumn("w");
+    man->CreateNtupleDColumn("e");      // eV
+    man->CreateNtupleDColumn("path");   // LAr path length, cm
+    man->CreateNtupleIColumn("nray");   // Rayleigh scatters
+    man->CreateNtupleIColumn("nanode"); // reflections off AnodeSurface
+    man->CreateNtupleIColumn("nfc");    // reflections off FCSurface
+    man->CreateNtupleIColumn("ncryo");  // reflections off CryostatSurface
+    man->FinishNtuple();
+  }
+
+  // Channel map of the geometry, one row per window (see
+  // DetectorConstruction::Channel); analysis macros select hv bins by group
+  // from it (channelmap.C). Written once, by the master.
+  if(IsMaster()){
+    const std::vector<DetectorConstruction::Channel>& channels = fDetector->GetChannels();
+    G4int id = man->CreateNtuple("channels", "channel map");
+    man->CreateNtupleIColumn("id");
+    man->CreateNtupleSColumn("name");
+    man->CreateNtupleSColumn("group");
+    man->CreateNtupleDColumn("x");      // window centre, mm
+    man->CreateNtupleDColumn("y");
+    man->CreateNtupleDColumn("z");
+    man->CreateNtupleDColumn("nx");     // normal into the LAr
+    man->CreateNtupleDColumn("ny");
+    man->CreateNtupleDColumn("nz");
+    man->CreateNtupleDColumn("dx");     // window size, mm
+    man->CreateNtupleDColumn("dy");
+    man->CreateNtupleDColumn("dz");
+    man->FinishNtuple();
+    for(size_t k=0; k<channels.size(); k++){
+      const DetectorConstruction::Channel& c = channels[k];
+      G4int col = 0;
+      man->FillNtupleIColumn(id, col++, c.id);
+      man->FillNtupleSColumn(id, col++, c.name);
+      man->FillNtupleSColumn(id, col++, DetectorConstruction::GroupName(c.group));
+      for(G4int a=0; a<3; a++) man->FillNtupleDColumn(id, col++, c.center[a]/mm);
+      for(G4int a=0; a<3; a++) man->FillNtupleDColumn(id, col++, c.normal[a]);
+      for(G4int a=0; a<3; a++) man->FillNtupleDColumn(id, col++, c.size[a]/mm);
+      man->AddNtupleRow(id);
+    }
+  }
+
   G4int nvols = 710;
   G4int hv_id = man->CreateH1("hv","",nvols+1,-0.5,nvols+0.5);
   G4int hdX_id = man->CreateH1("hdX","",40,-0.16875,0.16875);
@@ -70,12 +133,33 @@ void RunAction::BeginOfRunAction(const G4Run*)
     }
  
   fNumEvent = 0;
+
+  // geometry is closed here, voxels built
+  if(fDetector->GetNavigationStats() && IsMaster()) fDetector->PrintVoxelStats();
   
 }
 
-void RunAction::EndOfRunAction(const G4Run* /*aRun*/)
+void RunAction::EndOfRunAction(const G4Run* aRun)
 {     
   G4AnalysisManager* man = G4AnalysisManager::Instance();
+
+  // weighted photon counts: hv keeps sum(w) and sum(w^2) per bin, the
+  // run total is printed here with its statistical error
+  const B1Run* run = static_cast<const B1Run*>(aRun);
+  G4cout << G4endl << "Optical photons on windows: " << run->GetNDetected()
+         << " tracks, weighted sum " << run->GetDetWeight()
+         << " +- " << std::sqrt(run->GetDetWeight2()) << G4endl;
+  if(run->GetNRouletteKilled() > 0)
+    G4cout << "Photon roulette: " << run->GetNRouletteKilled() << " killed (weight "
+           << run->GetRouletteKilledWeight() << "), weight added to survivors "
+           << run->GetRouletteAddedWeight() << G4endl;
+  if(run->GetNCulled() > 0)
+    G4cout << "Photon culling: " << run->GetNCulled() << " removed (weight "
+           << run->GetCulledWeight() << "), weight added to survivors "
+           << run->GetCullingAddedWeight() << G4endl;
+  if(run->GetNNavSteps() > 0)
+    G4cout << "Navigation: " << run->GetNNavSteps() << " steps, daughters tested per step "
+           << run->GetNavCandidates()/run->GetNNavSteps() << G4endl;
   
   // save Rndm status
   if (fSaveRndm == 1)
@@ -0,0 +1,38 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "RunActionMessenger.hh"
+
+#include "RunAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+
+RunActionMessenger::RunActionMessenger(RunAction* run)
+:G4UImessenger(),fRunAction(run),fRunDir(0),fRecordCmd(0)
+{
+  fRunDir = new G4UIdirectory("/testem/run/");
+  fRunDir->SetGuidance("Run output control");
+
+  fRecordCmd = new G4UIcmdWithABool("/testem/run/recordPhotons",this);
+  fRecordCmd->SetGuidance("Write one row per detected photon to the 'photons' ntuple");
+  fRecordCmd->SetGuidance("(LAr path length, Rayleigh and surface reflection counts),");
+  fRecordCmd->SetGuidance("used by reweight.C for absorption/reflectivity scans");
+  fRecordCmd->SetParameterName("flag",true);
+  fRecordCmd->SetDefaultValue(true);
+  fRecordCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+RunActionMessenger::~RunActionMessenger()
+{
+  delete fRecordCmd;
+  delete fRunDir;
+}
+
+void RunActionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fRecordCmd)
+    { fRunAction->SetRecordPhotons(fRecordCmd->GetNewBoolValue(newValue));}
+}
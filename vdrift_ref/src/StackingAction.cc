@@ -0,0 +1,148 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "StackingAction.hh"
+#include "StackingActionMessenger.hh"
+#include "PhysicsList.hh"
+#include "TrackingAction.hh"
+#include "SteppingAction.hh"
+#include "DetectorConstruction.hh"
+#include "OpticalConstants.hh"
+#include "BoxTracer.hh"
+#include "BoxSceneBuilder.hh"
+#include "Run.hh"
+#include "g4root.hh"
+
+#include "G4Track.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4StackManager.hh"
+#include "G4RunManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "Randomize.hh"
+
+StackingAction::StackingAction(PhysicsList* physics, TrackingAction* tracking,
+                               SteppingAction* stepping)
+:G4UserStackingAction(),fMessenger(0),fPhysics(physics),fTracking(tracking),
+ fStepping(stepping),fTracer(0),fSceneBuild(0),
+ fDeferPhotons(true),fDropPhotons(false),fPhotonFraction(1.),fVerbose(0),
+ fUseTracer(false),fSceneFailed(false),
+ fNPhotons(0),fNSampledOut(0),fNTraced(0)
+{
+  fMessenger = new StackingActionMessenger(this);
+  fTracer = new BoxTracer();
+}
+
+StackingAction::~StackingAction()
+{
+  delete fMessenger;
+  delete fTracer;
+}
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* aTrack)
+{
+  if(aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition())
+    return fUrgent;
+
+  // already counted and sampled when it was born in the other period
+  if(SteppingAction::IsPeriodicImage(aTrack)) return fUrgent;
+
+  if(fPhotonFraction < 1.){
+    if(G4UniformRand() >= fPhotonFraction){
+      fNSampledOut++;
+      return fKill;
+    }
+    // not yet tracked, so the weight can still be set here
+    G4Track* track = const_cast<G4Track*>(aTrack);
+    track->SetWeight(track->GetWeight()/fPhotonFraction);
+  }
+
+  fNPhotons++;
+
+  if(fUseTracer){
+    OpticalConstants* constants = fPhysics->GetOpticalConstants();
+    G4double energy = aTrack->GetTotalEnergy();
+    if(constants && constants->IsLine(energy) && BuildScene(energy)
+       && fTracer->Contains(aTrack->GetPosition())){
+      // never reaches PreUserTrackingAction, so scale the yield here
+      G4Track* track = const_cast<G4Track*>(aTrack);
+      fTracking->ApplyYieldScale(track);
+      if(track->GetTrackStatus() != fStopAndKill){
+        fTracer->AddPhoton(track->GetPosition(), track->GetMomentumDirection(),
+                           track->GetPolarization(), track->GetWeight());
+        fNTraced++;
+      }
+      return fKill;
+    }
+  }
+
+  // dropping works on the batch moved in at NewStage, so it defers too
+  return (fDeferPhotons || fDropPhotons) ? fWaiting : fUrgent;
+}
+
+G4bool StackingAction::BuildScene(G4double energy)
+{
+  // the geometry is rebuilt by /testem/det/periods
+  const DetectorConstruction* detector = static_cast<const DetectorConstruction*>
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if(detector->GetNumberOfBuilds() == fSceneBuild) return fTracer->HasScene() && !fSceneFailed;
+  fSceneBuild = detector->GetNumberOfBuilds();
+  fSceneFailed = false;
+
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  BoxSceneBuilder builder(fStepping);
+  BoxScene scene;
+  if(!world || !builder.Build(world, energy, scene)){
+    G4cout << "StackingAction: no Cryostat box found, box tracer disabled" << G4endl;
+    fSceneFailed = true;
+    return false;
+  }
+  scene.periodicZ = detector->IsPeriodic();
+  fTracer->SetScene(scene);
+  if(fVerbose > 0)
+    G4cout << "StackingAction: box tracer scene with " << scene.boxes.size() << " boxes ("
+           << builder.GetNApproximated() << " solids replaced by their extent)" << G4endl;
+  return true;
+}
+
+void StackingAction::TraceBatch()
+{
+  std::vector<std::pair<G4int,G4double> > hits;
+  fTracer->Trace(hits);
+
+  G4AnalysisManager* man = G4AnalysisManager::Instance();
+  G4int hv_id = man->GetH1Id("hv");
+  B1Run* run = static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  for(size_t i=0; i<hits.size(); i++){
+    man->FillH1(hv_id,hits[i].first,hits[i].second);
+    run->AddDetection(hits[i].second);
+  }
+}
+
+void StackingAction::NewStage()
+{
+  // urgent stack is empty: the waiting photons have just been moved in
+  if(fVerbose > 0)
+    G4cout << "StackingAction: shower done, " << fNPhotons
+           << " optical photons stacked (" << fNSampledOut
+           << " sampled out, " << fNTraced << " box traced)"
+           << (fDropPhotons ? ", dropped" : "") << G4endl;
+
+  if(fDropPhotons){
+    stackManager->ClearUrgentStack();
+    fTracer->Clear();
+  }
+  else if(fTracer->GetNPhotons() > 0) TraceBatch();
+}
+
+void StackingAction::PrepareNewEvent()
+{
+  fNPhotons = 0;
+  fNSampledOut = 0;
+  fNTraced = 0;
+  fTracer->Clear();
+}
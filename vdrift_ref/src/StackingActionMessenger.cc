@@ -0,0 +1,75 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "StackingActionMessenger.hh"
+
+#include "StackingAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+StackingActionMessenger::StackingActionMessenger(StackingAction* stacking)
+:G4UImessenger(),fStacking(stacking),
+ fStackDir(0),fDeferCmd(0),fDropCmd(0),fFractionCmd(0),fVerboseCmd(0),fTracerCmd(0)
+{
+  fStackDir = new G4UIdirectory("/testem/stack/");
+  fStackDir->SetGuidance("Stacking of optical photons");
+
+  fDeferCmd = new G4UIcmdWithABool("/testem/stack/deferPhotons",this);
+  fDeferCmd->SetGuidance("Track optical photons after the charged shower");
+  fDeferCmd->SetParameterName("flag",true);
+  fDeferCmd->SetDefaultValue(true);
+
+  fDropCmd = new G4UIcmdWithABool("/testem/stack/dropPhotons",this);
+  fDropCmd->SetGuidance("Discard the deferred optical photons of each event");
+  fDropCmd->SetGuidance("(the photons are deferred whatever deferPhotons says)");
+  fDropCmd->SetParameterName("flag",true);
+  fDropCmd->SetDefaultValue(true);
+
+  fFractionCmd = new G4UIcmdWithADouble("/testem/stack/photonFraction",this);
+  fFractionCmd->SetGuidance("Fraction f of optical photons kept; kept photons get weight 1/f");
+  fFractionCmd->SetParameterName("f",false);
+  fFractionCmd->SetRange("f>0. && f<=1.");
+
+  fVerboseCmd = new G4UIcmdWithAnInteger("/testem/stack/verbose",this);
+  fVerboseCmd->SetGuidance("Print the number of stacked photons per event");
+  fVerboseCmd->SetParameterName("level",true);
+  fVerboseCmd->SetDefaultValue(1);
+
+  fTracerCmd = new G4UIcmdWithABool("/testem/stack/boxTracer",this);
+  fTracerCmd->SetGuidance("Trace line photons in the LAr box with the packet box tracer");
+  fTracerCmd->SetParameterName("flag",true);
+  fTracerCmd->SetDefaultValue(true);
+}
+
+StackingActionMessenger::~StackingActionMessenger()
+{
+  delete fDeferCmd;
+  delete fDropCmd;
+  delete fFractionCmd;
+  delete fVerboseCmd;
+  delete fTracerCmd;
+  delete fStackDir;
+}
+
+void StackingActionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{ 
+  if (command == fDeferCmd)
+    { fStacking->SetDeferPhotons(fDeferCmd->GetNewBoolValue(newValue));}
+
+  if (command == fDropCmd)
+    { fStacking->SetDropPhotons(fDropCmd->GetNewBoolValue(newValue));}
+
+  if (command == fFractionCmd)
+    { fStacking->SetPhotonFraction(fFractionCmd->GetNewDoubleValue(newValue));}
+
+  if (command == fVerboseCmd)
+    { fStacking->SetVerbose(fVerboseCmd->GetNewIntValue(newValue));}
+
+  if (command == fTracerCmd)
+    { fStacking->SetBoxTracer(fTracerCmd->GetNewBoolValue(newValue));}
+}
@@ -11,12 +11,29 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "DetectorConstruction.hh"
+#include "Run.hh"
+#include "PhotonRoulette.hh"
+#include "PhotonCulling.hh"
 #include "G4Alpha.hh"
+#include "G4OpticalPhoton.hh"
+#include "FastOpBoundaryProcess.hh"
+#include "ArrayParameterisation.hh"
+#include "NavigationStats.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4ProcessManager.hh"
+#include "G4RunManager.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4OpticalSurface.hh"
+#include "G4Material.hh"
 #include "g4root.hh"
 
-SteppingAction::SteppingAction(RunAction* run, DetectorConstruction* det)
-:fRun(run),fDetector(det)
+SteppingAction::SteppingAction(RunAction* run, DetectorConstruction* det, PhotonRoulette* roulette, PhotonCulling* culling)
+:fRun(run),fDetector(det),fRoulette(roulette),fCulling(culling),fFastBoundary(0),fBoundary(0),
+ fBoundaryLookedUp(false),fNReflections(0),
+ fLAr(0),fPathLength(0.),fNRayleigh(0)
 { 
+  fNSurface[0] = fNSurface[1] = fNSurface[2] = 0;
   idx=0;
   eveti = 0;
 }
@@ -28,6 +45,8 @@ SteppingAction::~SteppingAction()
     G4cout << p->first << " " << p->second << G4endl;
   }
 
+  delete fRoulette;
+  delete fCulling;
 }
 
 void SteppingAction::UserSteppingAction(const G4Step* aStep)
@@ -36,6 +55,19 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
   // Analysis manager
   
   G4AnalysisManager* man = G4AnalysisManager::Instance();
+
+  G4bool isPhoton = aStep->GetTrack()->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition();
+  if(fDetector->GetNavigationStats()){
+    // daughters of the pre-step volume in the voxel node of the step start
+    const G4StepPoint* pre = aStep->GetPreStepPoint();
+    const G4VTouchable* touchable = pre->GetTouchable();
+    G4ThreeVector local = touchable->GetHistory()->GetTopTransform().TransformPoint(pre->GetPosition());
+    static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun())
+      ->AddNavigationStep(NavigationStats::Candidates(touchable->GetVolume()->GetLogicalVolume(), local));
+  }
+
+  if(isPhoton) PhotonHistoryStep(aStep);
+  if(isPhoton && fDetector->IsPeriodic() && WrapPeriodic(aStep)) return;
   
   /*man->FillNtupleIColumn(1,0,fRun->GetNumEvent());
   man->FillNtupleIColumn(1,1,aStep->GetTrack()->GetDynamicParticle()->GetPDGcode());
@@ -62,9 +94,18 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
     if(aStep->GetTrack()->GetNextVolume()!=0){
       // G4cout << ", vol: " << aStep->GetTrack()->GetNextVolume()->GetName();
       std::pair<int,int> aux = VolumeCode( aStep->GetTrack()->GetNextVolume()->GetName());
+      // parameterised arrays share one window name; the copy carries the code
+      G4int channel = ArrayParameterisation::Channel(aStep->GetPostStepPoint()->GetTouchable());
+      if(channel >= 0) aux.first = channel;
       //if (aux.first < 5) return; // since we are not writing the ntuple and only filling one histo, this return statement is not necessary
       G4int hv_id = man->GetH1Id("hv"); // get histogram int identifier, searched by histogram name
-      man->FillH1(hv_id,aux.first); // fill histogram at thos volume code value, with weight 1
+      G4double weight = aStep->GetTrack()->GetWeight(); // 1 unless the optical yield is downscaled
+      man->FillH1(hv_id,aux.first,weight); // fill histogram at thos volume code value
+      if(aux.first >= 5 && isPhoton){
+        B1Run* run = static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+        run->AddDetection(weight);
+        if(fRun->GetRecordPhotons()) RecordPhoton(aStep,aux.first,weight);
+      }
       /*      man->FillNtupleIColumn(1,9,aux.first);
 	      man->FillNtupleIColumn(1,10,aStep->GetPostStepPoint()->GetTouchableHandle()->GetReplicaNumber());*/
       //      G4cout << " " << aux.first;
@@ -129,6 +170,141 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
 //  }
     // man->AddNtupleRow(1); // comment out filling on ntuple for now, as volume code histogram is sufficient
 
+  if(isPhoton) OpticalPhotonStep(aStep);
+}
+
+G4bool SteppingAction::IsPeriodicImage(const G4Track* track)
+{
+  // secondaries made by processes always have a creator
+  return track->GetParentID() > 0 && !track->GetCreatorProcess();
+}
+
+G4bool SteppingAction::WrapPeriodic(const G4Step* aStep)
+{
+  G4StepPoint* post = aStep->GetPostStepPoint();
+  if(post->GetStepStatus() != fGeomBoundary) return false;
+  if(!post->GetPhysicalVolume() || post->GetPhysicalVolume()->GetName() != "World") return false;
+  if(aStep->GetPreStepPoint()->GetPhysicalVolume()->GetName() != "Cryostat") return false;
+
+  G4double halfZ = fDetector->GetPeriodicHalfZ();
+  G4ThreeVector pos = post->GetPosition();
+  if(std::fabs(pos.z()) < halfZ - 1*um) return false;
+
+  // same photon through the opposite end; it is stacked as urgent, so it
+  // is tracked next and keeps the history of this one
+  G4Track* track = aStep->GetTrack();
+  pos.setZ(pos.z() > 0. ? -halfZ + 1*um : halfZ - 1*um);
+  G4Track* image = new G4Track(new G4DynamicParticle(*track->GetDynamicParticle()),
+                               post->GetGlobalTime(), pos);
+  image->SetWeight(track->GetWeight());
+  image->SetParentID(track->GetTrackID());
+  fpSteppingManager->GetfSecondary()->push_back(image);
+  track->SetTrackStatus(fStopAndKill);
+  return true;
+}
+
+void SteppingAction::PhotonHistoryStep(const G4Step* aStep)
+{
+  if(aStep->GetTrack()->GetCurrentStepNumber() == 1 && !IsPeriodicImage(aStep->GetTrack())){
+    fNReflections = 0;
+    fPathLength = 0.;
+    fNRayleigh = 0;
+    fNSurface[0] = fNSurface[1] = fNSurface[2] = 0;
+  }
+  if(!fLAr) fLAr = G4Material::GetMaterial("G4_lAr");
+
+  if(aStep->GetPreStepPoint()->GetMaterial() == fLAr)
+    fPathLength += aStep->GetStepLength();
+
+  const G4VProcess* proc = aStep->GetPostStepPoint()->GetProcessDefinedStep();
+  if(proc && proc->GetProcessName() == "OpRayleigh") fNRayleigh++;
+}
+
+void SteppingAction::RecordPhoton(const G4Step* aStep, G4int vol, G4double weight)
+{
+  // surface counts are those before this step: entering the window is not
+  // affected by the reflectivities being scanned
+  G4AnalysisManager* man = G4AnalysisManager::Instance();
+  man->FillNtupleIColumn(2,0,fRun->GetNumEvent());
+  man->FillNtupleIColumn(2,1,vol);
+  man->FillNtupleDColumn(2,2,weight);
+  man->FillNtupleDColumn(2,3,aStep->GetTrack()->GetTotalEnergy()/eV);
+  man->FillNtupleDColumn(2,4,fPathLength/cm);
+  man->FillNtupleIColumn(2,5,fNRayleigh);
+  man->FillNtupleIColumn(2,6,fNSurface[0]);
+  man->FillNtupleIColumn(2,7,fNSurface[1]);
+  man->FillNtupleIColumn(2,8,fNSurface[2]);
+  man->AddNtupleRow(2);
+}
+
+G4int SteppingAction::SurfaceClass(const G4Step* aStep) const
+{
+  // same skin lookup order as G4OpBoundaryProcess
+  G4VPhysicalVolume* pre = aStep->GetPreStepPoint()->GetPhysicalVolume();
+  G4VPhysicalVolume* post = aStep->GetPostStepPoint()->GetPhysicalVolume();
+  if(!pre || !post) return -1;
+
+  G4LogicalSkinSurface* skin = 0;
+  if(post->GetMotherLogical() == pre->GetLogicalVolume()){
+    skin = G4LogicalSkinSurface::GetSurface(post->GetLogicalVolume());
+    if(!skin) skin = G4LogicalSkinSurface::GetSurface(pre->GetLogicalVolume());
+  }else{
+    skin = G4LogicalSkinSurface::GetSurface(pre->GetLogicalVolume());
+    if(!skin) skin = G4LogicalSkinSurface::GetSurface(post->GetLogicalVolume());
+  }
+  if(!skin) return -1;
+
+  const G4String& name = skin->GetSurfaceProperty()->GetName();
+  if(name == "AnodeSurface") return 0;
+  if(name == "FCSurface") return 1;
+  if(name == "CryostatSurface") return 2;
+  return -1;
+}
+
+void SteppingAction::OpticalPhotonStep(const G4Step* aStep)
+{
+  G4Track* track = aStep->GetTrack();
+
+  if(!fBoundaryLookedUp){
+    fBoundaryLookedUp = true;
+    G4ProcessManager* pm = track->GetDefinition()->GetProcessManager();
+    G4ProcessVector* pv = pm->GetProcessList();
+    for(G4int i=0; i<pm->GetProcessListLength() && !fBoundary; i++){
+      fFastBoundary = dynamic_cast<FastOpBoundaryProcess*>((*pv)[i]);
+      fBoundary = fFastBoundary ? fFastBoundary
+                                : dynamic_cast<G4OpBoundaryProcess*>((*pv)[i]);
+    }
+    if(!fBoundary)
+      G4cerr << "SteppingAction: no optical boundary process, photon roulette,"
+             << " culling and surface counts disabled" << G4endl;
+  }
+  if(!fBoundary) return;
+
+  if(aStep->GetPostStepPoint()->GetStepStatus() != fGeomBoundary) return;
+
+  // GetStatus is not virtual: the fast path keeps its own status
+  G4OpBoundaryProcessStatus status =
+    fFastBoundary ? fFastBoundary->GetStatus() : fBoundary->GetStatus();
+
+  switch(status){
+  case FresnelReflection:
+  case TotalInternalReflection:
+  case LambertianReflection:
+  case LobeReflection:
+  case SpikeReflection:
+  case BackScattering:
+    fNReflections++;
+    {
+      G4int surf = SurfaceClass(aStep);
+      if(surf >= 0) fNSurface[surf]++;
+    }
+    // scoring above already used the weight carried up to this boundary
+    if(fRoulette->Apply(track, fNReflections)) break;
+    fCulling->Apply(track);
+    break;
+  default:
+    break;
+  }
 }
 
 std::pair<int,int> SteppingAction::VolumeCode(std::string name){
@@ -0,0 +1,64 @@
+// Arapuca simulation
+// Authors: L. Paulucci & F. Marinho
+// Date: 20th September 2016
+//
+// Added modifications should be reported in arapuca.cc header comments
+
+#include "TrackingAction.hh"
+#include "PhysicsList.hh"
+#include "PhotonCulling.hh"
+#include "OpticalConstants.hh"
+
+#include "G4Track.hh"
+#include "G4TrackingManager.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4VProcess.hh"
+#include "Randomize.hh"
+
+TrackingAction::TrackingAction(PhysicsList* phys, PhotonCulling* culling)
+:fPhysics(phys),fCulling(culling)
+{}
+
+TrackingAction::~TrackingAction()
+{}
+
+void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
+{
+  if(aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition()) return;
+  G4Track* track = fpTrackingManager->GetTrack();
+
+  ApplyYieldScale(track);
+
+  if(track->GetTrackStatus() == fStopAndKill) return;
+  fCulling->Apply(track);
+
+  // line photons: group velocity fixed once instead of looked up every step
+  OpticalConstants* constants = fPhysics->GetOpticalConstants();
+  if(constants && constants->IsLine(track->GetTotalEnergy()) && track->GetTouchable()){
+    track->SetVelocity(constants->Get(track->GetMaterial()).groupVelocity);
+    track->UseGivenVelocity(true);
+  }
+}
+
+void TrackingAction::ApplyYieldScale(G4Track* track)
+{
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if(!creator) return;
+
+  if(creator->GetProcessSubType() == fScintillation){
+    // yield already reduced in G4Scintillation, by the factor its process
+    // of this thread used
+    G4double fs = fPhysics->GetScintillationYieldFactor();
+    if(fs < 1.) track->SetWeight(track->GetWeight()/fs);
+    return;
+  }
+
+  G4double f = fPhysics->GetOpticalYieldScale();
+  if(f >= 1.) return;
+  if(creator->GetProcessSubType() == fCerenkov){
+    // G4Cerenkov has no yield factor, thin the photons here instead
+    if(G4UniformRand() >= f) track->SetTrackStatus(fStopAndKill);
+    else track->SetWeight(track->GetWeight()/f);
+  }
+}